@@ -0,0 +1,51 @@
+/**
+ * @file batch.h
+ * @brief Header file for batch functions
+ */
+
+#pragma once
+
+#include "proofCache.h"
+#include <iostream>
+#include <string>
+
+/**
+ * @defgroup batch Batch functions
+ * @brief Functions for proving many pairs of expressions in one run
+ * @{
+ */
+
+/**
+ * @brief Number of pairs read before they are proved and written, so the
+ * pairs are streamed without holding all of them
+ */
+const int BATCH_WINDOW = 1024;
+
+/**
+ * @brief Prove every pair of expressions read from a stream on several
+ * threads and write a line of JSON per pair in the order they were read.
+ *
+ * Every line holds a pair as `lhs ; rhs`, as written by generatePairs with
+ * `--corpus`. Empty lines and lines starting with `#` are skipped. Every
+ * result has the number of the line, both expressions as read, the status,
+ * which is one of "proved", "invalid", "not equivalent", "not found",
+ * "out of memory" or "timed out", the steps of the proof if proved and the
+ * seconds it took: {"line":1,"lhs":"p","rhs":"!!p","status":"proved",
+ * "steps":[{"expression":"p","law":"Given"},...],"seconds":0.001}
+ *
+ * The laws preprocess picks depend on the pair, but the search reads them
+ * from globals, so the pairs of a window are proved in groups that share
+ * their laws, one group at a time. Decomposed searches only get the threads
+ * of MAX_DECOMPOSITION_THREADS not already used for the pairs.
+ *
+ * @param input stream of the pairs
+ * @param output stream the results are written to
+ * @param threads number of pairs proved at once
+ * @param seconds time limit of every pair, none if 0
+ * @param cache proofs reused and added to, none if nullptr
+ *
+ * @return number of pairs read
+ */
+int proveBatch(std::istream &input, std::ostream &output, int threads, double seconds, ProofCache *cache = nullptr);
+
+/** @} */
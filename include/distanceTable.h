@@ -0,0 +1,196 @@
+/**
+ * @file distanceTable.h
+ * @brief Header file for distance table class
+ */
+
+#pragma once
+
+#include "expression.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Precomputed proofs between every pair of equivalent expressions up to
+ * a number of nodes over a few variables. Expressions are equivalent when
+ * they have the same truth table, and the smallest expression of every truth
+ * table is its canonical expression. The table gives every expression the
+ * next step of a shortest path to its canonical expression and the previous
+ * step of a shortest path from it, so a proof is two walks through the table.
+ * Only steps between expressions that fit in the table are followed, so an
+ * expression the bounded graph cannot connect to its canonical expression has
+ * no steps. Tables are built offline by build and memory-mapped by open. Once
+ * open, a table is read only and safe to use from several threads.
+ *
+ * Every expression is encoded as a 64-bit key, one 4-bit symbol per node in
+ * preorder. The file starts with a magic string, the maximum number of nodes,
+ * the number of variables, the number of laws and the number of expressions
+ * as 32-bit integers, then the law names, each a 32-bit length followed by
+ * its characters, then a record per expression sorted by key: the key, the
+ * index of the next and previous expressions as 32-bit integers and the laws
+ * of both steps as 16-bit integers.
+ */
+class DistanceTable {
+public:
+  /**
+   * @brief Construct a DistanceTable object without a file
+   */
+  DistanceTable();
+
+  /**
+   * @brief Unmap the file of the table
+   */
+  ~DistanceTable();
+
+  DistanceTable(const DistanceTable &) = delete;
+  DistanceTable &operator=(const DistanceTable &) = delete;
+
+  /**
+   * @brief Enumerate every expression up to a number of nodes over the first
+   * variables of the alphabet with every law, and write the table to a file
+   *
+   * @param path path to the file
+   * @param maxNodes maximum number of nodes of the expressions, at most 16
+   * @param variables number of variables, from a, at most 5
+   *
+   * @return bool of whether the file could be written
+   */
+  static bool build(const std::string &path, int maxNodes, int variables);
+
+  /**
+   * @brief Memory-map the file of a table
+   *
+   * @param path path to the file
+   *
+   * @return bool of whether the file could be opened and is a distance table
+   */
+  bool open(const std::string &path);
+
+  /**
+   * @brief Unmap the file of the table
+   */
+  void close();
+
+  /**
+   * @brief Prove two expressions with the table, through their canonical
+   * expression
+   *
+   * @param lhs pointer to left hand side expression
+   * @param rhs pointer to right hand side expression
+   * @param steps reference to the vector the steps are stored in
+   *
+   * @return bool of whether both expressions are in the table and share a
+   * canonical expression
+   */
+  bool find(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps) const;
+
+  /**
+   * @brief Get the number of expressions in the table
+   *
+   * @return number of expressions, 0 if no table is open
+   */
+  int size() const;
+
+  /**
+   * @brief Encode an expression as a key
+   *
+   * @param expression pointer to the expression
+   * @param variables number of variables the key can hold
+   * @param key reference to the key
+   *
+   * @return bool of whether the expression has at most 16 nodes and only the
+   * first variables
+   */
+  static bool encode(std::shared_ptr<Expression> expression, int variables, uint64_t &key);
+
+  /**
+   * @brief Decode a key to an expression
+   *
+   * @param key the key
+   *
+   * @return pointer to the expression
+   */
+  static std::shared_ptr<Expression> decode(uint64_t key);
+
+private:
+  /**
+   * @brief Record of an expression in the file
+   */
+  struct Record {
+    /**
+     * @brief Key of the expression
+     */
+    uint64_t key;
+
+    /**
+     * @brief Index of the next expression toward the canonical expression,
+     * the index of this expression if it is canonical
+     */
+    uint32_t toward;
+
+    /**
+     * @brief Index of the previous expression from the canonical expression,
+     * the index of this expression if it is canonical
+     */
+    uint32_t from;
+
+    /**
+     * @brief Law of the step to the next expression
+     */
+    uint16_t towardLaw;
+
+    /**
+     * @brief Law of the step from the previous expression
+     */
+    uint16_t fromLaw;
+  };
+
+  /**
+   * @brief Start of the memory-mapped file, nullptr if nothing is mapped
+   */
+  const char *mapped;
+
+  /**
+   * @brief Number of bytes of the memory-mapped file
+   */
+  size_t mappedSize;
+
+  /**
+   * @brief Start of the records in the mapped file
+   */
+  const char *records;
+
+  /**
+   * @brief Number of variables of the table
+   */
+  int variables;
+
+  /**
+   * @brief Number of expressions of the table
+   */
+  uint32_t count;
+
+  /**
+   * @brief Names of the laws of the table
+   */
+  std::vector<std::string> lawNames;
+
+  /**
+   * @brief Read a record of the mapped file
+   *
+   * @param index index of the record
+   *
+   * @return the record
+   */
+  Record read(uint32_t index) const;
+
+  /**
+   * @brief Find the record of a key with a binary search
+   *
+   * @param key the key
+   * @param index reference to the index of the record
+   *
+   * @return bool of whether the key is in the table
+   */
+  bool lookup(uint64_t key, uint32_t &index) const;
+};
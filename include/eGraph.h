@@ -0,0 +1,303 @@
+/**
+ * @file eGraph.h
+ * @brief Header file for e-graph class
+ */
+
+#pragma once
+
+#include "equivLaws.h"
+#include "expression.h"
+#include "lawIndex.h"
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief E-graph that stores every expression reached by the equivalence laws
+ * at once. Expressions are split into nodes that share their subexpressions,
+ * and nodes proven equal are merged into the same e-class. Laws are applied
+ * without removing anything, so the graph only grows until it is saturated
+ * or reaches its node budget. Every merge remembers the law or the
+ * congruence that justified it, so a proof can be read back from any two
+ * nodes of the same e-class.
+ */
+class EGraph {
+public:
+  /**
+   * @brief Construct an empty EGraph object
+   */
+  EGraph();
+
+  /**
+   * @brief Remove every node and rule from the e-graph
+   */
+  void clear();
+
+  /**
+   * @brief Add the rules of a law. Only rules whose sides are equivalent are
+   * added, so laws that are not sound in both directions cannot merge
+   * expressions that are not equal.
+   *
+   * @param law the equivalence law to add
+   */
+  void addRule(EquivLaws::EquivLaw law);
+
+  /**
+   * @brief Add the rules of every law of the map
+   *
+   * @param laws map of equivalence laws to their string representations
+   */
+  void addRules(const std::unordered_map<EquivLaws::EquivLaw, std::string> &laws);
+
+  /**
+   * @brief Add an expression and all of its subexpressions
+   *
+   * @param expression pointer to the expression
+   *
+   * @return id of the node of the expression
+   */
+  int add(std::shared_ptr<Expression> expression);
+
+  /**
+   * @brief Find the e-class of a node
+   *
+   * @param node id of the node
+   *
+   * @return id of the node representing the e-class
+   */
+  int find(int node);
+
+  /**
+   * @brief Merge the e-classes of two nodes. Call rebuild afterwards to merge
+   * the nodes that became congruent.
+   *
+   * @param a id of the first node
+   * @param b id of the second node
+   * @param law the equivalence law that rewrites one node into the other,
+   * nullptr if the nodes are congruent
+   *
+   * @return bool of whether the e-classes were different
+   */
+  bool merge(int a, int b, EquivLaws::EquivLaw law);
+
+  /**
+   * @brief Merge every pair of nodes with the same operator and children in
+   * the same e-classes until no such pair is left
+   *
+   * @return number of merges
+   */
+  int rebuild();
+
+  /**
+   * @brief Apply every rule at every e-class once, then rebuild. Stops
+   * adding nodes once the budget is reached.
+   *
+   * @param maxNodes maximum number of nodes in the e-graph
+   *
+   * @return number of merges, 0 once the e-graph is saturated or full
+   */
+  int step(int maxNodes);
+
+  /**
+   * @brief Get the number of nodes in the e-graph
+   *
+   * @return number of nodes
+   */
+  int size() const;
+
+  /**
+   * @brief Get the number of e-classes in the e-graph
+   *
+   * @return number of e-classes
+   */
+  int classCount() const;
+
+  /**
+   * @brief Get the steps that rewrite one node into another of the same
+   * e-class
+   *
+   * @param a id of the first node
+   * @param b id of the second node
+   *
+   * @return vector of vector of strings of the steps: {{a, "Given"}, {expr,
+   * law},...}, empty if the nodes are in different e-classes
+   */
+  std::vector<std::vector<std::string>> explain(int a, int b);
+
+private:
+  /**
+   * @brief Operator or variable with the ids of its children
+   */
+  struct Node {
+    /**
+     * @brief Value of the expression, an operator, variable or constant
+     */
+    std::string value;
+
+    /**
+     * @brief Ids of the nodes of the subexpressions, left first
+     */
+    std::vector<int> children;
+
+    /**
+     * @brief Order nodes by value, then by children
+     *
+     * @param other the other node
+     *
+     * @return bool of whether this node comes first
+     */
+    bool operator<(const Node &other) const
+    {
+      return value != other.value ? value < other.value : children < other.children;
+    }
+  };
+
+  /**
+   * @brief Rule of a law with its pattern variables named p, q, r, s
+   */
+  struct Rule {
+    /**
+     * @brief The law the rule belongs to
+     */
+    EquivLaws::EquivLaw law;
+
+    /**
+     * @brief Left hand side of the rule
+     */
+    std::shared_ptr<Expression> lhs;
+
+    /**
+     * @brief Right hand side of the rule
+     */
+    std::shared_ptr<Expression> rhs;
+  };
+
+  /**
+   * @brief E-classes bound to the pattern variables, -1 if unbound
+   */
+  typedef std::array<int, rules::MAX_VARIABLES> Bindings;
+
+  /**
+   * @brief Every node, the id of a node is its index
+   */
+  std::vector<Node> nodes;
+
+  /**
+   * @brief Union-find parent of every node
+   */
+  std::vector<int> parents;
+
+  /**
+   * @brief Map of the representative of every e-class to its nodes
+   */
+  std::unordered_map<int, std::vector<int>> classes;
+
+  /**
+   * @brief Map of every node, with its children replaced by their e-classes,
+   * to a node. Up to date after rebuild.
+   */
+  std::map<Node, int> hashcons;
+
+  /**
+   * @brief Map of every node to its id, used so an expression is never
+   * stored twice
+   */
+  std::map<Node, int> terms;
+
+  /**
+   * @brief Parent of every node in the proof forest, -1 for a root
+   */
+  std::vector<int> proofParents;
+
+  /**
+   * @brief Law of the edge to the proof forest parent, nullptr for a
+   * congruence
+   */
+  std::vector<EquivLaws::EquivLaw> proofLaws;
+
+  /**
+   * @brief Rules applied by step
+   */
+  std::vector<Rule> rules;
+
+  /**
+   * @brief Laws whose rules were added
+   */
+  std::set<EquivLaws::EquivLaw> ruleLaws;
+
+  /**
+   * @brief Rules already applied with the same bound e-classes
+   */
+  std::set<std::pair<int, Bindings>> applied;
+
+  /**
+   * @brief Add a node unless it is already stored. A new node that is
+   * congruent to another one is merged with it.
+   *
+   * @param node the node
+   *
+   * @return id of the node
+   */
+  int addNode(const Node &node);
+
+  /**
+   * @brief Replace the children of a node with their e-classes
+   *
+   * @param node the node
+   *
+   * @return the node with canonical children
+   */
+  Node canonicalize(Node node);
+
+  /**
+   * @brief Find every way a pattern matches a node of an e-class
+   *
+   * @param pattern pointer to the pattern
+   * @param eClass id of the e-class
+   * @param bindings e-classes bound so far
+   * @param matches reference to the vector the bindings are appended to
+   */
+  void match(std::shared_ptr<Expression> pattern, int eClass, Bindings bindings, std::vector<Bindings> &matches);
+
+  /**
+   * @brief Add the nodes of a pattern with its variables replaced by their
+   * e-classes
+   *
+   * @param pattern pointer to the pattern
+   * @param bindings e-classes bound to the pattern variables
+   *
+   * @return id of the node of the pattern
+   */
+  int instantiate(std::shared_ptr<Expression> pattern, const Bindings &bindings);
+
+  /**
+   * @brief Reverse the edges from a node to the root of its proof tree
+   *
+   * @param node id of the node that becomes the root
+   */
+  void makeProofRoot(int node);
+
+  /**
+   * @brief Build the expression of a node
+   *
+   * @param node id of the node
+   *
+   * @return pointer to the expression
+   */
+  std::shared_ptr<Expression> term(int node);
+
+  /**
+   * @brief Append the steps that rewrite the subexpression at a position
+   * from one node into another of the same e-class
+   *
+   * @param a id of the node the subexpression is now
+   * @param b id of the node the subexpression becomes
+   * @param position path from the root to the subexpression
+   * @param root reference to the pointer of the whole expression
+   * @param steps reference to the vector the steps are appended to
+   */
+  void explain(int a, int b, const std::string &position, std::shared_ptr<Expression> &root, std::vector<std::vector<std::string>> &steps);
+};
@@ -6,7 +6,9 @@
 #pragma once
 
 #include "expression.h"
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 
 /**
@@ -38,6 +40,74 @@ public:
    */
   static std::unordered_map<EquivLaw, std::string> bidirectionalImplications;
 
+  /**
+   * @brief Map of equivalence laws to the law that exactly undoes them when
+   * applied right after at the same position
+   */
+  static std::unordered_map<EquivLaw, EquivLaw> inverses;
+
+  /**
+   * @brief Step of a macro
+   */
+  struct MacroStep {
+    /**
+     * @brief The law applied
+     */
+    EquivLaw law;
+
+    /**
+     * @brief Path from the subexpression the macro applies to to the
+     * subexpression the law applies to, 'L' for left and 'R' for right
+     */
+    std::string position;
+  };
+
+  /**
+   * @brief Maximum number of macros registered at the same time
+   */
+  static constexpr int MAX_MACROS = 8;
+
+  /**
+   * @brief Map of registered macros to their string representations, the
+   * names of their laws joined by " + "
+   */
+  static std::unordered_map<EquivLaw, std::string> macros;
+
+  /**
+   * @brief Register a sequence of laws as a single composite law that applies
+   * all of them or none
+   *
+   * @param steps the laws in the order they are applied
+   *
+   * @return the new law, nullptr if there are fewer than two steps or
+   * MAX_MACROS are already registered
+   */
+  static EquivLaw addMacro(const std::vector<MacroStep> &steps);
+
+  /**
+   * @brief Get the steps of a macro
+   *
+   * @param law the macro
+   *
+   * @return the steps, empty if the law is not a registered macro
+   */
+  static std::vector<MacroStep> getMacroSteps(EquivLaw law);
+
+  /**
+   * @brief Unregister every macro
+   */
+  static void clearMacros();
+
+  /**
+   * @brief Get the name of an equivalence law
+   *
+   * @param law the equivalence law
+   *
+   * @return name of the law, empty if it is not in laws, implications,
+   * bidirectionalImplications or macros
+   */
+  static std::string getName(EquivLaw law);
+
   /**
    * @brief Replace the current expression with the new expression
    *
@@ -461,4 +531,39 @@ public:
    * @see bidirectionalImplication4()
    */
   static bool bidirectionalImplication4Reversed(std::shared_ptr<Expression> &expression);
+
+private:
+  /**
+   * @brief Steps of the registered macros, indexed by their slot
+   */
+  static std::vector<std::vector<MacroStep>> macroSteps;
+
+  /**
+   * @brief Apply the macro in a slot
+   *
+   * @param slot index of the macro in macroSteps
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether every step of the macro was applied
+   */
+  static bool applyMacro(int slot, std::shared_ptr<Expression> &expression);
+
+  /**
+   * @brief Law of the macro in a slot, one function per slot since laws are
+   * plain function pointers
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether every step of the macro was applied
+   */
+  template <int Slot>
+  static bool macro(std::shared_ptr<Expression> &expression)
+  {
+    return applyMacro(Slot, expression);
+  }
+
+  /**
+   * @brief Laws of every slot
+   */
+  static const EquivLaw macroLaws[MAX_MACROS];
 };
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cctype>
 #include <iostream>
 #include <memory>
@@ -83,6 +84,23 @@ public:
    */
   bool isVar();
 
+  /**
+   * @brief Get the number of nodes in the current expression and
+   * subexpressions. Kept up to date whenever a subexpression is set.
+   *
+   * @return number of nodes
+   */
+  int getSize();
+
+  /**
+   * @brief Get the number of levels in the current expression and
+   * subexpressions, a single node has depth 1. Kept up to date whenever a
+   * subexpression is set.
+   *
+   * @return number of levels
+   */
+  int getDepth();
+
   /**
    * @brief Get the parent expression of the current expression
    *
@@ -210,4 +228,20 @@ private:
    * @brief Pointer to right subexpression
    */
   std::shared_ptr<Expression> right;
+
+  /**
+   * @brief Number of nodes in the current expression and subexpressions
+   */
+  int size;
+
+  /**
+   * @brief Number of levels in the current expression and subexpressions
+   */
+  int depth;
+
+  /**
+   * @brief Recompute the size and depth from the subexpressions and pass the
+   * change up to the parent expressions
+   */
+  void updateMetrics();
 };
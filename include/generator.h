@@ -0,0 +1,50 @@
+/**
+ * @file generator.h
+ * @brief Header file for random problem functions
+ */
+
+#pragma once
+
+#include "expression.h"
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @defgroup generator Random problem functions
+ * @brief Functions for making random pairs of equivalent expressions whose
+ * proof length is known, for stress tests and benchmarks
+ * @{
+ */
+
+/**
+ * @brief Make a random expression of &, |, !, -> and <=>. Every variable
+ * appears at least once if the expression has enough leaves for all of them.
+ *
+ * @param random the random number generator
+ * @param variables number of variables, named from a
+ * @param nodes number of nodes of the expression, at least 1
+ *
+ * @return pointer to the expression
+ */
+std::shared_ptr<Expression> randomExpression(std::mt19937 &random, int variables, int nodes);
+
+/**
+ * @brief Rewrite an expression with random laws, using the laws preprocess
+ * picks for it. Every step leads to an expression not seen before and stays
+ * within MAX_NODES and MAX_DEPTH, so the search could take it. Steps whose
+ * result is not equivalent to the subexpression they rewrite are left out,
+ * so the last expression is always equivalent to the first. Calls
+ * preprocess, which replaces the laws used by the solver.
+ *
+ * @param expr pointer to the expression to rewrite
+ * @param rewrites number of laws to apply
+ * @param random the random number generator
+ *
+ * @return vector of vector of strings of the steps from the expression:
+ * {{expr, "Given"}, {expr, law},...}. Shorter than asked if no law leads to
+ * a new expression.
+ */
+std::vector<std::vector<std::string>> randomRewrites(std::shared_ptr<Expression> expr, int rewrites, std::mt19937 &random);
+
+/** @} */
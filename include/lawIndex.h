@@ -0,0 +1,148 @@
+/**
+ * @file lawIndex.h
+ * @brief Header file for law index class
+ */
+
+#pragma once
+
+#include "equivLaws.h"
+#include "expression.h"
+#include "rules.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Discrimination tree built from the left hand sides of equivalence
+ * laws. Finds every law that applies to an expression in a single top-down
+ * pass, so the cost per expression does not depend on the number of laws.
+ */
+class LawIndex {
+public:
+  /**
+   * @brief Map of equivalence laws to the patterns of their rules
+   */
+  static const std::unordered_map<EquivLaws::EquivLaw, std::vector<rules::RulePattern>> patterns;
+
+  /**
+   * @brief Construct an empty LawIndex object
+   */
+  LawIndex();
+
+  /**
+   * @brief Remove every law from the index
+   */
+  void clear();
+
+  /**
+   * @brief Add a law to the index. Laws without registered patterns are
+   * returned as candidates for every expression.
+   *
+   * @param law the equivalence law to add
+   */
+  void insert(EquivLaws::EquivLaw law);
+
+  /**
+   * @brief Add every law of the map to the index
+   *
+   * @param laws map of equivalence laws to their string representations
+   */
+  void insert(const std::unordered_map<EquivLaws::EquivLaw, std::string> &laws);
+
+  /**
+   * @brief Find the laws that can be applied to the expression
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return vector of the applicable laws in the order they were inserted
+   */
+  std::vector<EquivLaws::EquivLaw> match(std::shared_ptr<Expression> expression) const;
+
+  /**
+   * @brief Get the size and depth the expression would have after applying
+   * the law, without building anything
+   *
+   * @param law the equivalence law to apply
+   * @param expression pointer to the current expression
+   * @param size reference to the number of nodes of the result
+   * @param depth reference to the number of levels of the result
+   *
+   * @return bool of whether the law has patterns and can be applied
+   */
+  static bool measure(EquivLaws::EquivLaw law, std::shared_ptr<Expression> expression, int &size, int &depth);
+
+  /**
+   * @brief Get the number of laws in the index
+   *
+   * @return number of laws in the index
+   */
+  int size() const;
+
+private:
+  /**
+   * @brief Rule stored at a leaf of the discrimination tree
+   */
+  struct Entry {
+    /**
+     * @brief The law the rule belongs to
+     */
+    EquivLaws::EquivLaw law;
+
+    /**
+     * @brief Insertion order of the law
+     */
+    int order;
+
+    /**
+     * @brief Exact matcher of the rule
+     */
+    bool (*matches)(const std::shared_ptr<Expression> &);
+  };
+
+  /**
+   * @brief Node of the discrimination tree
+   */
+  struct Node {
+    /**
+     * @brief Child nodes keyed by symbol, "*" for a pattern variable
+     */
+    std::unordered_map<std::string, int> children;
+
+    /**
+     * @brief Rules whose pattern ends at this node
+     */
+    std::vector<Entry> entries;
+  };
+
+  /**
+   * @brief Nodes of the discrimination tree, the first node is the root
+   */
+  std::vector<Node> nodes;
+
+  /**
+   * @brief Laws without registered patterns
+   */
+  std::vector<Entry> unindexed;
+
+  /**
+   * @brief Insertion order of every law in the index
+   */
+  std::unordered_map<EquivLaws::EquivLaw, int> order;
+
+  /**
+   * @brief Add the pattern of a single rule to the discrimination tree
+   *
+   * @param pattern pointer to the left hand side of the rule
+   * @param entry the rule to store at the leaf
+   */
+  void insertPattern(std::shared_ptr<Expression> pattern, Entry entry);
+
+  /**
+   * @brief Walk the discrimination tree along the remaining subexpressions
+   *
+   * @param node index of the current node
+   * @param pending subexpressions still to be matched, the next one is last
+   * @param entries reference to the vector of rules found so far
+   */
+  void retrieve(int node, std::vector<std::shared_ptr<Expression>> &pending, std::vector<Entry> &entries) const;
+};
@@ -0,0 +1,50 @@
+/**
+ * @file normalForm.h
+ * @brief Header file for normal form functions
+ */
+
+#pragma once
+
+#include "equivLaws.h"
+#include "expression.h"
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @defgroup normalForm Normal form functions
+ * @brief Functions for rewriting expressions into a canonical normal form
+ * @{
+ */
+
+/**
+ * @brief Maximum number of variables normalize rewrites with
+ */
+const int MAX_NORMAL_FORM_VARIABLES = 6;
+
+/**
+ * @brief Rewrite an expression into its canonical disjunctive normal form
+ * using only equivalence laws, one step at a time and in a fixed order.
+ * The normal form is a disjunction of every satisfying assignment of the
+ * variables, each a conjunction of one literal per variable, sorted and
+ * nested to the right. A contradiction becomes F. Equivalent expressions
+ * rewritten with the same variables end in the same normal form.
+ *
+ * With n variables the normal form has up to 2^n conjunctions, so the
+ * number of steps and the time taken grow exponentially with n: six
+ * variables take thousands of steps and more quickly run out of memory.
+ *
+ * Some steps use a law from right to left, such as the Identity Law to turn
+ * p into p & T when a variable is missing from a term.
+ *
+ * @param expr pointer to the expression to rewrite
+ * @param variables every variable that must appear in the normal form
+ *
+ * @return vector of vector of strings of the steps from the expression to
+ * its normal form: {{expr, "Given"}, {expr, law},...}. Empty if the
+ * expression contains ^, which no law rewrites, or if the expression and
+ * the variables have more than MAX_NORMAL_FORM_VARIABLES variables together.
+ */
+std::vector<std::vector<std::string>> normalize(std::shared_ptr<Expression> expr, std::set<std::string> variables);
+
+/** @} */
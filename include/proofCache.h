@@ -0,0 +1,182 @@
+/**
+ * @file proofCache.h
+ * @brief Header file for proof cache class
+ */
+
+#pragma once
+
+#include "expression.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Proofs stored in an append-only file, keyed by the fingerprints of
+ * their expressions. The file is memory-mapped when it is opened, and every
+ * new proof is appended to it, so proofs survive restarts. Expressions are
+ * compared by their fully parenthesized strings, so the same expression
+ * typed differently finds the same proof. Safe to use from several threads.
+ *
+ * The file starts with a magic string, followed by records of a 32-bit byte
+ * count, the two 64-bit fingerprints, and the lhs, the rhs and the steps as
+ * strings, each a 32-bit length followed by its characters. A record cut
+ * short by a crash is dropped when the file is opened.
+ */
+class ProofCache {
+public:
+  /**
+   * @brief Construct a ProofCache object without a file
+   */
+  ProofCache();
+
+  /**
+   * @brief Close the file of the cache
+   */
+  ~ProofCache();
+
+  ProofCache(const ProofCache &) = delete;
+  ProofCache &operator=(const ProofCache &) = delete;
+
+  /**
+   * @brief Open the file of the cache and load the proofs in it, creating
+   * the file if it does not exist
+   *
+   * @param path path to the file
+   *
+   * @return bool of whether the file could be opened and is a proof cache
+   */
+  bool open(const std::string &path);
+
+  /**
+   * @brief Close the file of the cache and forget its proofs
+   */
+  void close();
+
+  /**
+   * @brief Find the proof of two expressions
+   *
+   * @param lhs pointer to left hand side expression
+   * @param rhs pointer to right hand side expression
+   * @param steps reference to the vector the steps are stored in
+   *
+   * @return bool of whether the proof was found
+   */
+  bool find(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps);
+
+  /**
+   * @brief Add the proof of two expressions and append it to the file.
+   * Proofs that are already cached are not added again.
+   *
+   * @param lhs pointer to left hand side expression
+   * @param rhs pointer to right hand side expression
+   * @param steps steps of the proof: {{lhs, law},...}
+   *
+   * @return bool of whether the proof was appended to the file
+   */
+  bool insert(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, const std::vector<std::vector<std::string>> &steps);
+
+  /**
+   * @brief Get every proof in the cache
+   *
+   * @return the steps of every proof: {{lhs, law},...}
+   */
+  std::vector<std::vector<std::vector<std::string>>> proofs();
+
+  /**
+   * @brief Get the number of proofs in the cache
+   *
+   * @return number of proofs
+   */
+  int size();
+
+  /**
+   * @brief Get the fingerprint of an expression, a 64-bit FNV-1a hash of its
+   * fully parenthesized string
+   *
+   * @param expression pointer to the expression
+   *
+   * @return the fingerprint
+   */
+  static uint64_t fingerprint(std::shared_ptr<Expression> expression);
+
+private:
+  /**
+   * @brief Fingerprints of the lhs and the rhs
+   */
+  typedef std::pair<uint64_t, uint64_t> Key;
+
+  /**
+   * @brief Hash of a pair of fingerprints
+   */
+  struct KeyHash {
+    /**
+     * @brief Combine the fingerprints of a key
+     *
+     * @param key the key
+     *
+     * @return hash of the key
+     */
+    size_t operator()(const Key &key) const { return key.first ^ (key.second * 0x9e3779b97f4a7c15ULL); }
+  };
+
+  /**
+   * @brief Start of the memory-mapped file, nullptr if nothing is mapped
+   */
+  const char *mapped;
+
+  /**
+   * @brief Number of bytes of the memory-mapped file
+   */
+  size_t mappedSize;
+
+  /**
+   * @brief Path to the file, empty while no file is open
+   */
+  std::string path;
+
+  /**
+   * @brief Map of keys to the offsets of their records in the mapped file
+   */
+  std::unordered_map<Key, std::vector<size_t>, KeyHash> offsets;
+
+  /**
+   * @brief Records appended since the file was mapped, decoded
+   */
+  std::unordered_map<Key, std::vector<std::vector<std::string>>, KeyHash> appended;
+
+  /**
+   * @brief Lock held by every public function
+   */
+  std::mutex lock;
+
+  /**
+   * @brief Unmap the file and forget its proofs without taking the lock
+   */
+  void reset();
+
+  /**
+   * @brief Decode a record of the mapped file
+   *
+   * @param offset offset of the record
+   * @param strings reference to the vector the strings of the record are
+   * stored in: lhs, rhs, then the expression and law of every step
+   *
+   * @return bool of whether the record is complete
+   */
+  bool decode(size_t offset, std::vector<std::string> &strings) const;
+
+  /**
+   * @brief Find the proof of two expressions without taking the lock
+   *
+   * @param key fingerprints of the expressions
+   * @param lhsString string of the lhs
+   * @param rhsString string of the rhs
+   * @param steps reference to the vector the steps are stored in
+   *
+   * @return bool of whether the proof was found
+   */
+  bool findUnlocked(const Key &key, const std::string &lhsString, const std::string &rhsString, std::vector<std::vector<std::string>> &steps) const;
+};
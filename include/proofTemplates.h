@@ -0,0 +1,162 @@
+/**
+ * @file proofTemplates.h
+ * @brief Header file for proof templates class
+ */
+
+#pragma once
+
+#include "expression.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Library of solved proofs whose variables stand for any
+ * subexpression. A proof of `p -> q` and `!q -> !p` also proves
+ * `(a & b) -> c` and `!c -> !(a & b)`, since every law still applies once
+ * the variables are replaced. The left hand sides of the templates are
+ * stored in a discrimination tree, like the laws in LawIndex, so the
+ * templates a problem could be an instance of are found in a single pass.
+ * Safe to use from several threads.
+ */
+class ProofTemplates {
+public:
+  /**
+   * @brief Construct an empty ProofTemplates object
+   */
+  ProofTemplates();
+
+  /**
+   * @brief Remove every template
+   */
+  void clear();
+
+  /**
+   * @brief Add a solved proof as a template. Proofs with fewer than two
+   * steps, proofs already added and proofs with variables that are in
+   * neither expression are left out.
+   *
+   * @param lhs pointer to left hand side expression
+   * @param rhs pointer to right hand side expression
+   * @param steps steps of the proof: {{lhs, law},...}
+   *
+   * @return bool of whether the template was added
+   */
+  bool insert(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, const std::vector<std::vector<std::string>> &steps);
+
+  /**
+   * @brief Prove two expressions with the shortest template they are an
+   * instance of
+   *
+   * @param lhs pointer to left hand side expression
+   * @param rhs pointer to right hand side expression
+   * @param steps reference to the vector the steps are stored in
+   *
+   * @return bool of whether a template was found
+   */
+  bool instantiate(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps);
+
+  /**
+   * @brief Get the number of templates
+   *
+   * @return number of templates
+   */
+  int size();
+
+private:
+  /**
+   * @brief Map of variables to the subexpressions they stand for
+   */
+  typedef std::unordered_map<std::string, std::shared_ptr<Expression>> Substitution;
+
+  /**
+   * @brief Solved proof with variables
+   */
+  struct Template {
+    /**
+     * @brief Left hand side of the proof
+     */
+    std::shared_ptr<Expression> lhs;
+
+    /**
+     * @brief Right hand side of the proof
+     */
+    std::shared_ptr<Expression> rhs;
+
+    /**
+     * @brief Expression of every step after the lhs
+     */
+    std::vector<std::shared_ptr<Expression>> expressions;
+
+    /**
+     * @brief Law of every step after the lhs
+     */
+    std::vector<std::string> laws;
+  };
+
+  /**
+   * @brief Node of the discrimination tree
+   */
+  struct Node {
+    /**
+     * @brief Child nodes keyed by symbol, "*" for a variable
+     */
+    std::unordered_map<std::string, int> children;
+
+    /**
+     * @brief Templates whose lhs ends at this node
+     */
+    std::vector<int> templates;
+  };
+
+  /**
+   * @brief Every template
+   */
+  std::vector<Template> templates;
+
+  /**
+   * @brief Strings of the lhs and rhs of every template, joined by " = "
+   */
+  std::unordered_map<std::string, int> added;
+
+  /**
+   * @brief Nodes of the discrimination tree, the first node is the root
+   */
+  std::vector<Node> nodes;
+
+  /**
+   * @brief Lock held by every public function
+   */
+  std::mutex lock;
+
+  /**
+   * @brief Walk the discrimination tree along the remaining subexpressions
+   *
+   * @param node index of the current node
+   * @param pending subexpressions still to be matched, the next one is last
+   * @param found reference to the vector of templates found so far
+   */
+  void retrieve(int node, std::vector<std::shared_ptr<Expression>> &pending, std::vector<int> &found) const;
+
+  /**
+   * @brief Match a pattern against an expression, binding its variables
+   *
+   * @param pattern pointer to the pattern
+   * @param expression pointer to the expression
+   * @param substitution reference to the bindings so far
+   *
+   * @return bool of whether the expression is an instance of the pattern
+   */
+  static bool match(std::shared_ptr<Expression> pattern, std::shared_ptr<Expression> expression, Substitution &substitution);
+
+  /**
+   * @brief Build a pattern with its variables replaced
+   *
+   * @param pattern pointer to the pattern
+   * @param substitution bindings of every variable of the pattern
+   *
+   * @return pointer to the new expression
+   */
+  static std::shared_ptr<Expression> substitute(std::shared_ptr<Expression> pattern, const Substitution &substitution);
+};
@@ -0,0 +1,648 @@
+/**
+ * @file rules.h
+ * @brief Header-only compile-time rewrite rules
+ *
+ * Patterns are written as types, e.g.
+ * `Rule<And<P, Or<Q, R>>, Or<And<P, Q>, And<P, R>>>`, so the compiler
+ * generates an inlined matcher and constructor for every rule instead of
+ * dispatching through function pointers.
+ */
+
+#pragma once
+
+#include "equivLaws.h"
+#include "expression.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Compile-time rewrite rules mirroring EquivLaws
+ */
+namespace rules {
+
+/**
+ * @brief Maximum number of distinct pattern variables in a rule
+ */
+constexpr int MAX_VARIABLES = 4;
+
+/**
+ * @brief Subexpressions bound to the pattern variables of a rule
+ */
+typedef std::array<std::shared_ptr<Expression>, MAX_VARIABLES> Bindings;
+
+/**
+ * @brief Runtime description of a single rule
+ */
+struct RulePattern {
+  /**
+   * @brief Left hand side with pattern variables named p, q, r, s
+   */
+  std::shared_ptr<Expression> lhs;
+
+  /**
+   * @brief Right hand side with pattern variables named p, q, r, s
+   */
+  std::shared_ptr<Expression> rhs;
+
+  /**
+   * @brief Exact matcher of the rule, including repeated variables
+   */
+  bool (*matches)(const std::shared_ptr<Expression> &);
+
+  /**
+   * @brief Size and depth of the result of the rule without building it
+   */
+  bool (*measure)(const std::shared_ptr<Expression> &, int &, int &);
+};
+
+/**
+ * @brief Pattern variable that matches any subexpression
+ *
+ * Repeated occurrences of the same variable must match structurally equal
+ * subexpressions.
+ *
+ * @tparam N index of the variable, rendered as p, q, r, s
+ */
+template <int N> struct Var {
+  static_assert(N >= 0 && N < MAX_VARIABLES, "pattern variable out of range");
+
+  /**
+   * @brief Bind the variable or check it against its previous binding
+   *
+   * @param expression pointer to the subexpression to match
+   * @param bindings current variable bindings
+   *
+   * @return bool of whether the subexpression matches
+   */
+  static bool match(const std::shared_ptr<Expression> &expression, Bindings &bindings)
+  {
+    if (!bindings[N])
+    {
+      bindings[N] = expression;
+      return true;
+    }
+    return bindings[N] == expression || bindings[N]->compare(expression);
+  }
+
+  /**
+   * @brief Build the subexpression bound to the variable
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return pointer to the bound subexpression
+   */
+  static std::shared_ptr<Expression> build(const Bindings &bindings)
+  {
+    return bindings[N];
+  }
+
+  /**
+   * @brief Get the size of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of nodes
+   */
+  static int size(const Bindings &bindings) { return bindings[N]->getSize(); }
+
+  /**
+   * @brief Get the depth of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of levels
+   */
+  static int depth(const Bindings &bindings) { return bindings[N]->getDepth(); }
+
+  /**
+   * @brief Build the pattern as an expression with named variables
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> pattern()
+  {
+    return std::make_shared<Expression>(std::string(1, static_cast<char>('p' + N)));
+  }
+};
+
+/**
+ * @brief Pattern that matches a constant leaf
+ *
+ * @tparam Value struct holding the string value of the constant
+ */
+template <class Value> struct Constant {
+  /**
+   * @brief Check that the subexpression is the constant
+   *
+   * @param expression pointer to the subexpression to match
+   * @param bindings current variable bindings
+   *
+   * @return bool of whether the subexpression matches
+   */
+  static bool match(const std::shared_ptr<Expression> &expression, [[maybe_unused]] Bindings &bindings)
+  {
+    return expression->getValue() == Value::value;
+  }
+
+  /**
+   * @brief Build a new constant leaf
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return pointer to the new constant
+   */
+  static std::shared_ptr<Expression> build([[maybe_unused]] const Bindings &bindings)
+  {
+    return std::make_shared<Expression>(Value::value);
+  }
+
+  /**
+   * @brief Get the size of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of nodes
+   */
+  static int size([[maybe_unused]] const Bindings &bindings) { return 1; }
+
+  /**
+   * @brief Get the depth of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of levels
+   */
+  static int depth([[maybe_unused]] const Bindings &bindings) { return 1; }
+
+  /**
+   * @brief Build the pattern as an expression
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> pattern()
+  {
+    return std::make_shared<Expression>(Value::value);
+  }
+};
+
+/**
+ * @brief Pattern that matches a unary operator
+ *
+ * @tparam Op struct holding the string value of the operator
+ * @tparam X pattern of the operand
+ */
+template <class Op, class X> struct Unary {
+  /**
+   * @brief Match the operator and its operand
+   *
+   * @param expression pointer to the subexpression to match
+   * @param bindings current variable bindings
+   *
+   * @return bool of whether the subexpression matches
+   */
+  static bool match(const std::shared_ptr<Expression> &expression, Bindings &bindings)
+  {
+    return expression->getValue() == Op::value && expression->hasLeft() &&
+           X::match(expression->getLeft(), bindings);
+  }
+
+  /**
+   * @brief Build a new operator node over the built operand
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return pointer to the new expression
+   */
+  static std::shared_ptr<Expression> build(const Bindings &bindings)
+  {
+    std::shared_ptr<Expression> expression = std::make_shared<Expression>(Op::value);
+    expression->setLeft(X::build(bindings), expression);
+    return expression;
+  }
+
+  /**
+   * @brief Get the size of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of nodes
+   */
+  static int size(const Bindings &bindings) { return 1 + X::size(bindings); }
+
+  /**
+   * @brief Get the depth of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of levels
+   */
+  static int depth(const Bindings &bindings) { return 1 + X::depth(bindings); }
+
+  /**
+   * @brief Build the pattern as an expression with named variables
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> pattern()
+  {
+    std::shared_ptr<Expression> expression = std::make_shared<Expression>(Op::value);
+    expression->setLeft(X::pattern(), expression);
+    return expression;
+  }
+};
+
+/**
+ * @brief Pattern that matches a binary operator
+ *
+ * @tparam Op struct holding the string value of the operator
+ * @tparam L pattern of the left operand
+ * @tparam R pattern of the right operand
+ */
+template <class Op, class L, class R> struct Binary {
+  /**
+   * @brief Match the operator and both operands
+   *
+   * @param expression pointer to the subexpression to match
+   * @param bindings current variable bindings
+   *
+   * @return bool of whether the subexpression matches
+   */
+  static bool match(const std::shared_ptr<Expression> &expression, Bindings &bindings)
+  {
+    return expression->getValue() == Op::value && expression->isBinary() &&
+           L::match(expression->getLeft(), bindings) &&
+           R::match(expression->getRight(), bindings);
+  }
+
+  /**
+   * @brief Build a new operator node over the built operands
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return pointer to the new expression
+   */
+  static std::shared_ptr<Expression> build(const Bindings &bindings)
+  {
+    std::shared_ptr<Expression> expression = std::make_shared<Expression>(Op::value);
+    expression->setLeft(L::build(bindings), expression);
+    expression->setRight(R::build(bindings), expression);
+    return expression;
+  }
+
+  /**
+   * @brief Get the size of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of nodes
+   */
+  static int size(const Bindings &bindings) { return 1 + L::size(bindings) + R::size(bindings); }
+
+  /**
+   * @brief Get the depth of the built subexpression without building it
+   *
+   * @param bindings variable bindings of a successful match
+   *
+   * @return number of levels
+   */
+  static int depth(const Bindings &bindings) { return 1 + std::max(L::depth(bindings), R::depth(bindings)); }
+
+  /**
+   * @brief Build the pattern as an expression with named variables
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> pattern()
+  {
+    std::shared_ptr<Expression> expression = std::make_shared<Expression>(Op::value);
+    expression->setLeft(L::pattern(), expression);
+    expression->setRight(R::pattern(), expression);
+    return expression;
+  }
+};
+
+/**
+ * @defgroup ruleSymbols Rule symbols
+ * @brief String values of the operators and constants used in rules
+ * @{
+ */
+struct TrueValue { static constexpr const char *value = TRUE; };
+struct FalseValue { static constexpr const char *value = FALSE; };
+struct NotOp { static constexpr const char *value = NOT; };
+struct AndOp { static constexpr const char *value = AND; };
+struct OrOp { static constexpr const char *value = OR; };
+struct XorOp { static constexpr const char *value = XOR; };
+struct ImpliesOp { static constexpr const char *value = IMPLIES; };
+struct IffOp { static constexpr const char *value = IFF; };
+/** @} */
+
+/**
+ * @defgroup rulePatterns Rule patterns
+ * @brief Pattern building blocks for rules
+ * @{
+ */
+typedef Var<0> P;
+typedef Var<1> Q;
+typedef Var<2> R;
+typedef Var<3> S;
+typedef Constant<TrueValue> True;
+typedef Constant<FalseValue> False;
+template <class X> struct Not : Unary<NotOp, X> {};
+template <class L, class R> struct And : Binary<AndOp, L, R> {};
+template <class L, class R> struct Or : Binary<OrOp, L, R> {};
+template <class L, class R> struct Xor : Binary<XorOp, L, R> {};
+template <class L, class R> struct Implies : Binary<ImpliesOp, L, R> {};
+template <class L, class R> struct Iff : Binary<IffOp, L, R> {};
+/** @} */
+
+/**
+ * @brief Rewrite rule from one pattern to another
+ *
+ * @tparam Lhs pattern to match
+ * @tparam Rhs pattern to build from the bindings of the match
+ */
+template <class Lhs, class Rhs> struct Rule {
+  /**
+   * @brief Check if the rule can be applied to the expression
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether the left hand side matches
+   */
+  static bool matches(const std::shared_ptr<Expression> &expression)
+  {
+    Bindings bindings;
+    return Lhs::match(expression, bindings);
+  }
+
+  /**
+   * @brief Applies the rule. Has the same signature as EquivLaws::EquivLaw.
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether the rule was applied
+   */
+  static bool apply(std::shared_ptr<Expression> &expression)
+  {
+    Bindings bindings;
+    if (!Lhs::match(expression, bindings))
+      return false;
+
+    EquivLaws::replace(expression, Rhs::build(bindings));
+    return true;
+  }
+
+  /**
+   * @brief Get the size and depth the expression would have after applying
+   * the rule, without building anything
+   *
+   * @param expression pointer to the current expression
+   * @param size reference to the number of nodes of the result
+   * @param depth reference to the number of levels of the result
+   *
+   * @return bool of whether the rule can be applied
+   */
+  static bool measure(const std::shared_ptr<Expression> &expression, int &size, int &depth)
+  {
+    Bindings bindings;
+    if (!Lhs::match(expression, bindings))
+      return false;
+
+    size = Rhs::size(bindings);
+    depth = Rhs::depth(bindings);
+    return true;
+  }
+
+  /**
+   * @brief Build the left hand side as an expression with named variables
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> lhs() { return Lhs::pattern(); }
+
+  /**
+   * @brief Build the right hand side as an expression with named variables
+   *
+   * @return pointer to the pattern expression
+   */
+  static std::shared_ptr<Expression> rhs() { return Rhs::pattern(); }
+
+  /**
+   * @brief Describe the rule at runtime
+   *
+   * @return the pattern of the rule
+   */
+  static RulePattern describe() { return {lhs(), rhs(), matches, measure}; }
+};
+
+/**
+ * @brief Law made of one or more rules. The first matching rule is applied.
+ *
+ * @tparam Key the EquivLaws function the law mirrors
+ * @tparam Rules rules of the law in the order they are tried
+ */
+template <EquivLaws::EquivLaw Key, class... Rules> struct Law {
+  /**
+   * @brief The EquivLaws function the law mirrors
+   */
+  static constexpr EquivLaws::EquivLaw key = Key;
+
+  /**
+   * @brief Check if any rule of the law can be applied to the expression
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether a rule matches
+   */
+  static bool matches(const std::shared_ptr<Expression> &expression)
+  {
+    return (Rules::matches(expression) || ...);
+  }
+
+  /**
+   * @brief Applies the first matching rule. Has the same signature as
+   * EquivLaws::EquivLaw.
+   *
+   * @param expression pointer to the current expression
+   *
+   * @return bool of whether the law was applied
+   */
+  static bool apply(std::shared_ptr<Expression> &expression)
+  {
+    return (Rules::apply(expression) || ...);
+  }
+
+  /**
+   * @brief Describe the rules of the law at runtime
+   *
+   * @return vector of the patterns of the rules in the order they are tried
+   */
+  static std::vector<RulePattern> describe() { return {Rules::describe()...}; }
+};
+
+/**
+ * @brief Fixed set of laws that is iterated at compile time
+ *
+ * @tparam Laws laws in the set
+ */
+template <class... Laws> struct LawSet {
+  /**
+   * @brief Call the callback with every law of the set that matches the
+   * expression. The callback receives a default constructed law, so a generic
+   * lambda can call `decltype(law)::apply` without any indirection.
+   *
+   * @param expression pointer to the current expression
+   * @param callback callable taking a law
+   */
+  template <class Callback>
+  static void forEachMatch(const std::shared_ptr<Expression> &expression, Callback &&callback)
+  {
+    (
+        [&]()
+        {
+          if (Laws::matches(expression))
+            callback(Laws());
+        }(),
+        ...);
+  }
+
+  /**
+   * @brief Apply the law of the set that mirrors an EquivLaws function. The
+   * function is only compared with the keys of the laws, the law itself is
+   * called directly.
+   *
+   * @param law the EquivLaws function
+   * @param expression pointer to the current expression
+   * @param applied reference to whether the law was applied
+   *
+   * @return bool of whether the set has a law that mirrors the function
+   */
+  static bool apply(EquivLaws::EquivLaw law, std::shared_ptr<Expression> &expression, bool &applied)
+  {
+    return ((law == Laws::key && (applied = Laws::apply(expression), true)) || ...);
+  }
+
+  /**
+   * @brief Describe every law of the set at runtime
+   *
+   * @param patterns reference to the map the patterns of every law are added
+   * to, keyed by the EquivLaws function the law mirrors
+   */
+  static void describe(std::unordered_map<EquivLaws::EquivLaw, std::vector<RulePattern>> &patterns)
+  {
+    (patterns.insert({Laws::key, Laws::describe()}), ...);
+  }
+};
+
+/**
+ * @defgroup ruleLaws Rule laws
+ * @brief Compile-time equivalents of the EquivLaws functions
+ * @{
+ */
+typedef Law<EquivLaws::identity, Rule<And<P, True>, P>, Rule<Or<P, False>, P>> Identity;
+typedef Law<EquivLaws::domination, Rule<And<P, False>, False>, Rule<Or<P, True>, True>> Domination;
+typedef Law<EquivLaws::idempotent, Rule<And<P, P>, P>, Rule<Or<P, P>, P>> Idempotent;
+typedef Law<EquivLaws::doubleNegation, Rule<Not<Not<P>>, P>> DoubleNegation;
+typedef Law<EquivLaws::commutative, Rule<And<P, Q>, And<Q, P>>, Rule<Or<P, Q>, Or<Q, P>>> Commutative;
+typedef Law<EquivLaws::associative, Rule<And<And<P, Q>, R>, And<P, And<Q, R>>>,
+            Rule<Or<Or<P, Q>, R>, Or<P, Or<Q, R>>>>
+    Associative;
+typedef Law<EquivLaws::associativeReversed, Rule<And<P, And<Q, R>>, And<And<P, Q>, R>>,
+            Rule<Or<P, Or<Q, R>>, Or<Or<P, Q>, R>>>
+    AssociativeReversed;
+typedef Law<EquivLaws::distributive, Rule<And<P, Or<Q, R>>, Or<And<P, Q>, And<P, R>>>,
+            Rule<Or<P, And<Q, R>>, And<Or<P, Q>, Or<P, R>>>>
+    Distributive;
+typedef Law<EquivLaws::distributiveReversed, Rule<And<Or<P, Q>, Or<P, R>>, Or<P, And<Q, R>>>,
+            Rule<Or<And<P, Q>, And<P, R>>, And<P, Or<Q, R>>>>
+    DistributiveReversed;
+typedef Law<EquivLaws::deMorgan, Rule<Not<Or<P, Q>>, And<Not<P>, Not<Q>>>,
+            Rule<Not<And<P, Q>>, Or<Not<P>, Not<Q>>>>
+    DeMorgan;
+typedef Law<EquivLaws::deMorganReversed, Rule<And<Not<P>, Not<Q>>, Not<Or<P, Q>>>,
+            Rule<Or<Not<P>, Not<Q>>, Not<And<P, Q>>>>
+    DeMorganReversed;
+typedef Law<EquivLaws::absorption, Rule<Or<P, And<P, Q>>, P>, Rule<And<P, Or<P, Q>>, P>> Absorption;
+typedef Law<EquivLaws::negation, Rule<Or<P, Not<P>>, True>, Rule<And<P, Not<P>>, False>> Negation;
+
+typedef Law<EquivLaws::implication0, Rule<Implies<P, Q>, Or<Not<P>, Q>>> Implication0;
+typedef Law<EquivLaws::implication0Reversed, Rule<Or<Not<P>, Q>, Implies<P, Q>>> Implication0Reversed;
+typedef Law<EquivLaws::implication1, Rule<Implies<P, Q>, Implies<Not<Q>, Not<P>>>> Implication1;
+typedef Law<EquivLaws::implication1Reversed, Rule<Implies<Not<Q>, Not<P>>, Implies<P, Q>>> Implication1Reversed;
+typedef Law<EquivLaws::implication2, Rule<Or<P, Q>, Implies<Not<P>, Q>>> Implication2;
+typedef Law<EquivLaws::implication2Reversed, Rule<Implies<Not<P>, Q>, Or<P, Q>>> Implication2Reversed;
+typedef Law<EquivLaws::implication3, Rule<And<P, Q>, Not<Implies<P, Not<Q>>>>> Implication3;
+typedef Law<EquivLaws::implication3Reversed, Rule<Not<Implies<P, Not<Q>>>, And<P, Q>>> Implication3Reversed;
+typedef Law<EquivLaws::implication4, Rule<Not<Implies<P, Q>>, And<P, Not<Q>>>> Implication4;
+typedef Law<EquivLaws::implication4Reversed, Rule<And<P, Not<Q>>, Not<Implies<P, Q>>>> Implication4Reversed;
+typedef Law<EquivLaws::implication5, Rule<And<Implies<P, Q>, Implies<P, R>>, Implies<P, And<Q, R>>>> Implication5;
+typedef Law<EquivLaws::implication5Reversed, Rule<Implies<P, And<Q, R>>, And<Implies<P, Q>, Implies<P, R>>>> Implication5Reversed;
+typedef Law<EquivLaws::implication6, Rule<And<Implies<P, Q>, Implies<Q, R>>, Implies<Or<P, Q>, R>>> Implication6;
+typedef Law<EquivLaws::implication6Reversed, Rule<Implies<Or<P, Q>, R>, And<Implies<P, Q>, Implies<Q, R>>>> Implication6Reversed;
+typedef Law<EquivLaws::implication7, Rule<Or<Implies<P, Q>, Implies<P, R>>, Implies<P, Or<Q, R>>>> Implication7;
+typedef Law<EquivLaws::implication7Reversed, Rule<Implies<P, Or<Q, R>>, Or<Implies<P, Q>, Implies<P, R>>>> Implication7Reversed;
+typedef Law<EquivLaws::implication8, Rule<Or<Implies<P, Q>, Implies<Q, R>>, Implies<And<P, Q>, R>>> Implication8;
+typedef Law<EquivLaws::implication8Reversed, Rule<Implies<And<P, Q>, R>, Or<Implies<P, Q>, Implies<Q, R>>>> Implication8Reversed;
+
+typedef Law<EquivLaws::bidirectionalImplication0, Rule<Iff<P, Q>, And<Implies<P, Q>, Implies<Q, P>>>> BidirectionalImplication0;
+typedef Law<EquivLaws::bidirectionalImplication0Reversed, Rule<And<Implies<P, Q>, Implies<Q, R>>, Iff<P, Q>>> BidirectionalImplication0Reversed;
+typedef Law<EquivLaws::bidirectionalImplication1, Rule<Iff<P, Q>, Iff<Q, P>>> BidirectionalImplication1;
+typedef Law<EquivLaws::bidirectionalImplication2, Rule<Iff<P, Q>, Iff<Not<P>, Not<Q>>>> BidirectionalImplication2;
+typedef Law<EquivLaws::bidirectionalImplication2Reversed, Rule<Iff<Not<P>, Not<Q>>, Iff<P, Q>>> BidirectionalImplication2Reversed;
+typedef Law<EquivLaws::bidirectionalImplication3, Rule<Iff<P, Q>, Or<And<P, Q>, And<Not<P>, Not<Q>>>>> BidirectionalImplication3;
+typedef Law<EquivLaws::bidirectionalImplication3Reversed, Rule<Or<And<P, Q>, And<R, S>>, Iff<P, Q>>> BidirectionalImplication3Reversed;
+typedef Law<EquivLaws::bidirectionalImplication4, Rule<Not<Iff<P, Q>>, Iff<P, Not<Q>>>> BidirectionalImplication4;
+typedef Law<EquivLaws::bidirectionalImplication4Reversed, Rule<Iff<P, Not<Q>>, Not<Iff<P, Q>>>> BidirectionalImplication4Reversed;
+/** @} */
+
+/**
+ * @brief Compile-time equivalent of EquivLaws::laws
+ */
+typedef LawSet<Identity, Domination, Idempotent, DoubleNegation, Commutative,
+               Associative, AssociativeReversed, Distributive,
+               DistributiveReversed, DeMorgan, DeMorganReversed, Absorption,
+               Negation>
+    Laws;
+
+/**
+ * @brief Compile-time equivalent of EquivLaws::implications
+ */
+typedef LawSet<Implication0, Implication0Reversed, Implication1,
+               Implication1Reversed, Implication2, Implication2Reversed,
+               Implication3, Implication3Reversed, Implication4,
+               Implication4Reversed, Implication5, Implication5Reversed,
+               Implication6, Implication6Reversed, Implication7,
+               Implication7Reversed, Implication8, Implication8Reversed>
+    Implications;
+
+/**
+ * @brief Compile-time equivalent of EquivLaws::bidirectionalImplications
+ */
+typedef LawSet<BidirectionalImplication0, BidirectionalImplication0Reversed,
+               BidirectionalImplication1, BidirectionalImplication2,
+               BidirectionalImplication2Reversed, BidirectionalImplication3,
+               BidirectionalImplication3Reversed, BidirectionalImplication4,
+               BidirectionalImplication4Reversed>
+    BidirectionalImplications;
+
+/**
+ * @brief Apply the law that mirrors an EquivLaws function, without calling
+ * through the function pointer
+ *
+ * @param law the EquivLaws function
+ * @param expression pointer to the current expression
+ * @param applied reference to whether the law was applied
+ *
+ * @return bool of whether a law mirrors the function, false for laws such as
+ * macros that only exist as functions
+ */
+inline bool apply(EquivLaws::EquivLaw law, std::shared_ptr<Expression> &expression, bool &applied)
+{
+  return Laws::apply(law, expression, applied) ||
+         Implications::apply(law, expression, applied) ||
+         BidirectionalImplications::apply(law, expression, applied);
+}
+
+} // namespace rules
@@ -5,12 +5,20 @@
 
 #pragma once
 
+#include "distanceTable.h"
 #include "equivLaws.h"
 #include "expression.h"
+#include "lawIndex.h"
+#include "proofTemplates.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
 #include <queue>
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <iterator>
 
 /**
  * @defgroup solver Solver functions
@@ -18,24 +26,313 @@
  * @{
  */
 
+/**
+ * @brief Law that can be applied at a position of an expression
+ */
+struct Match {
+  /**
+   * @brief Path from the root to the subexpression, 'L' for left and 'R' for
+   * right
+   */
+  std::string position;
+
+  /**
+   * @brief The law that can be applied
+   */
+  EquivLaws::EquivLaw law;
+};
+
+/**
+ * @brief Expression in the queue of the proof search
+ */
+struct SearchState {
+  /**
+   * @brief Pointer to the root of the expression
+   */
+  std::shared_ptr<Expression> expr;
+
+  /**
+   * @brief Every law that can be applied to the expression, in preorder of
+   * their positions
+   */
+  std::vector<Match> matches;
+
+  /**
+   * @brief The match that produced the expression, the law is nullptr for the
+   * starting expression
+   */
+  Match producedBy;
+
+  /**
+   * @brief String of the expression while the state is stored compactly. The
+   * expression and its matches are only rebuilt from it when the state is
+   * processed.
+   */
+  std::string exprString = "";
+};
+
+/**
+ * @brief Estimated memory used by the proof search
+ */
+struct SearchMemory {
+  /**
+   * @brief Bytes used by the queue and the visited map
+   */
+  size_t used = 0;
+
+  /**
+   * @brief Whether new states are stored compactly, set once half of
+   * MAX_MEMORY_MB is used
+   */
+  bool compact = false;
+};
+
+/**
+ * @brief Outcome of a proof search
+ */
+enum class ProofStatus {
+  Proved,
+  NotFound,
+  OutOfMemory,
+  TimedOut,
+  Cancelled
+};
+
+/**
+ * @brief Strategy used to search for a proof
+ */
+enum class SearchMode {
+  BreadthFirst,
+  IterativeDeepening,
+  Beam,
+  UniformCost,
+  NormalForm,
+  EGraph
+};
+
+/**
+ * @brief Statistics of a proof search
+ */
+struct SearchStats {
+  /**
+   * @brief Number of states taken from the queue and expanded
+   */
+  int expanded = 0;
+
+  /**
+   * @brief Number of new states added to the queue
+   */
+  int generated = 0;
+
+  /**
+   * @brief Number of new expressions left out because they were visited
+   * before
+   */
+  int duplicates = 0;
+
+  /**
+   * @brief Number of new expressions left out because they have more than
+   * MAX_NODES nodes or MAX_DEPTH levels
+   */
+  int lengthRejected = 0;
+
+  /**
+   * @brief Map of law names to the number of times a law with the name was
+   * tried on a match
+   */
+  std::map<std::string, int> lawAttempts;
+
+  /**
+   * @brief Map of law names to the number of times a law with the name
+   * applied
+   */
+  std::map<std::string, int> lawSuccesses;
+
+  /**
+   * @brief Number of states queued at every number of steps from the lhs, by
+   * the breadth-first, iterative deepening and beam searches
+   */
+  std::vector<int> frontier;
+
+  /**
+   * @brief Highest estimated number of bytes used by the queue and the visited
+   * map
+   */
+  size_t peakMemory = 0;
+
+  /**
+   * @brief Highest number of expressions in the visited map, or of nodes in
+   * the e-graph
+   */
+  size_t peakVisited = 0;
+
+  /**
+   * @brief Wall-clock time of the search in seconds
+   */
+  double seconds = 0;
+
+  /**
+   * @brief Map of the searches and passes that ran, such as "Breadth-First
+   * Search" or "Shortening", to their wall-clock time in seconds
+   */
+  std::map<std::string, double> phaseSeconds;
+};
+
+/**
+ * @brief Result of a proof search
+ */
+struct ProofResult {
+  /**
+   * @brief Whether the proof was found, and why not otherwise
+   */
+  ProofStatus status;
+
+  /**
+   * @brief Steps to prove the equivalence: {{lhs, law},...}, empty unless
+   * the status is Proved
+   */
+  std::vector<std::vector<std::string>> steps;
+
+  /**
+   * @brief Statistics of the search, also filled when the search stopped early
+   */
+  SearchStats stats;
+};
+
+/**
+ * @brief Add the statistics of a search to the statistics of another. Counts,
+ * times and frontiers are summed and peaks are the higher of the two.
+ *
+ * @param total reference to the statistics added to
+ * @param other the statistics to add
+ */
+void addStats(SearchStats &total, const SearchStats &other);
+
+/**
+ * @brief Quote a string for JSON
+ *
+ * @param str the string
+ *
+ * @return the string in quotes, with quotes, backslashes and control
+ * characters escaped
+ */
+std::string jsonString(const std::string &str);
+
+/**
+ * @brief Render statistics as a JSON object
+ *
+ * @param stats the statistics
+ *
+ * @return the JSON object on a single line
+ */
+std::string statsToJson(const SearchStats &stats);
+
 /**
  * @brief Map of equivalences to be applied to the expressions
  */
 extern std::unordered_map<EquivLaws::EquivLaw, std::string> equivalences;
 
 /**
- * @brief Maximum size of the queue of expressions to be processed
+ * @brief Index of the equivalences, used to find the laws that apply to an
+ * expression without trying each of them
+ */
+extern LawIndex equivalenceIndex;
+
+/**
+ * @brief Proofs found by proveEquivalence, reused for the problems that are
+ * instances of them
+ */
+extern ProofTemplates proofTemplates;
+
+/**
+ * @brief Precomputed proofs of small problems, used by proveEquivalence once
+ * a table is open
+ */
+extern DistanceTable distanceTable;
+
+/**
+ * @brief Maximum memory in megabytes used by the queue of expressions to be
+ * processed and the map of visited expressions
+ */
+extern int MAX_MEMORY_MB;
+
+/**
+ * @brief Maximum number of steps of a proof found by the iterative deepening
+ * and beam searches
+ */
+extern int MAX_PROOF_LENGTH;
+
+/**
+ * @brief Maximum number of expressions in the transposition table of the
+ * iterative deepening search
+ */
+extern int TRANSPOSITION_TABLE_SIZE;
+
+/**
+ * @brief Number of expressions kept at every step of the beam search
  */
-extern int MAX_QUEUE_SIZE;
+extern int BEAM_WIDTH;
 
 /**
- * @brief Maximum length of the expressions in the queue 
+ * @brief Cost of a step with a law that is not in LAW_COSTS
  */
-extern int MAX_EXPRESSION_LENGTH;
+extern int DEFAULT_LAW_COST;
 
 /**
- * @brief Fill the map of equivalences to be applied to the expressions.
- * Must be called before any other functions in this file.
+ * @brief Map of law names to the cost of a step with the law, used by the
+ * uniform-cost search
+ */
+extern std::unordered_map<std::string, int> LAW_COSTS;
+
+/**
+ * @brief Maximum number of nodes of the e-graph built by the e-graph search
+ */
+extern int MAX_EGRAPH_NODES;
+
+/**
+ * @brief Maximum number of threads decomposedSearch runs at once, shared by
+ * every search. Pairs of children are proved on the calling thread once
+ * they are all busy.
+ */
+extern int MAX_DECOMPOSITION_THREADS;
+
+/**
+ * @brief Number of steps of the windows shortenProof searches for a shorter
+ * proof between, below 2 to leave proofs as they are
+ */
+extern int SHORTEN_WINDOW;
+
+/**
+ * @brief Whether the breadth-first search first leaves alone the
+ * subexpressions that already equal the rhs at the same position, and only
+ * searches everything if that finds no proof
+ */
+extern bool FREEZE_ALIGNED;
+
+/**
+ * @brief Whether proveEquivalence proves the instances of earlier proofs with
+ * proofTemplates instead of searching
+ */
+extern bool USE_TEMPLATES;
+
+/**
+ * @brief Strategy used by proveEquivalence
+ */
+extern SearchMode SEARCH_MODE;
+
+/**
+ * @brief Maximum number of nodes of the expressions in the queue
+ */
+extern int MAX_NODES;
+
+/**
+ * @brief Maximum number of levels of the expressions in the queue
+ */
+extern int MAX_DEPTH;
+
+/**
+ * @brief Fill the map of equivalences to be applied to the expressions and
+ * build their index. Must be called before any other functions in this file.
  */
 void preprocess(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
 
@@ -55,22 +352,433 @@ void preprocess(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs
 std::vector<std::vector<std::string>> proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
 
 /**
- * @brief Generate the next expressions from the current expression.
- * Creates a new expression for each law that can be applied to the current
- * expression and adds it to the queue of steps to be processed if the
- * expression has not already been visited.
+ * @brief Prove the expressions are equivalent like proveEquivalence above,
+ * and keep the statistics of the search
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param stats reference to the statistics of the search
+ *
+ * @return vector of vector of strings of the steps to prove the equivalence:
+ * {{lhs, law},...}
+ */
+std::vector<std::vector<std::string>> proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, SearchStats &stats);
+
+/**
+ * @brief Prove the expressions are equivalent within a time budget. The
+ * deadline and the cancellation token are checked before every expansion, so
+ * the search stops within one expansion of either. Searches with the
+ * strategy of SEARCH_MODE. A breadth-first search that runs out of memory
+ * falls back to the iterative deepening search, and one that cannot find a
+ * proof within its limits falls back to the normal form search. Proofs that
+ * are not known to be the shortest are passed through shortenProof with
+ * SHORTEN_WINDOW. Expressions that can be decomposed are proved one pair of
+ * children at a time instead. The variables are renamed by getRenaming
+ * before searching and the steps are renamed back, so problems that only
+ * differ in their variable names are searched the same way. Problems
+ * in an open distanceTable are proved with it without searching. With
+ * USE_TEMPLATES, problems that are an instance of a proof in proofTemplates
+ * are proved with it without searching, and every new proof is added to
+ * proofTemplates.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set, possibly from
+ * another thread
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+ProofResult proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Get the renaming of the variables of two expressions to a, b, c,...
+ * in the order they first appear, in the lhs and then in the rhs
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ *
+ * @return map of every variable to its new name
+ */
+std::unordered_map<std::string, std::string> getRenaming(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
+
+/**
+ * @brief Swap the variables and new names of a renaming
+ *
+ * @param renaming map of variables to their new names
+ *
+ * @return map of the new names to their variables
+ */
+std::unordered_map<std::string, std::string> invertRenaming(const std::unordered_map<std::string, std::string> &renaming);
+
+/**
+ * @brief Copy an expression with its variables renamed
+ *
+ * @param expr pointer to the expression
+ * @param renaming map of variables to their new names, variables not in it
+ * keep their names
+ *
+ * @return pointer to the renamed copy
+ */
+std::shared_ptr<Expression> renameVariables(std::shared_ptr<Expression> expr, const std::unordered_map<std::string, std::string> &renaming);
+
+/**
+ * @brief Rename the variables of every step of a proof
+ *
+ * @param steps steps of the proof: {{lhs, law},...}
+ * @param renaming map of variables to their new names
+ *
+ * @return the renamed steps
+ */
+std::vector<std::vector<std::string>> renameSteps(const std::vector<std::vector<std::string>> &steps, const std::unordered_map<std::string, std::string> &renaming);
+
+/**
+ * @brief Check if two expressions have the same operator and pairwise
+ * equivalent children, so they can be proved one child at a time
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ *
+ * @return bool of whether the expressions can be decomposed
+ *
+ * @see isEquivalent
+ */
+bool isDecomposable(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs);
+
+/**
+ * @brief Prove decomposable expressions equivalent one pair of children at a
+ * time. The left pair is proved on another thread while the right pair is
+ * proved on this one, each with proveEquivalence so the pairs are decomposed
+ * further. Once MAX_DECOMPOSITION_THREADS threads are busy, the left pair is
+ * proved first on this thread instead. proveEquivalence searches the whole
+ * problem if a pair is not proved. The proof rewrites the left child first, then the right child.
+ * Searching each pair on its own avoids trying every order of independent
+ * steps, but a proof that needs a law across both children is not found.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of both
+ * searches, the first status that is not Proved otherwise
+ *
+ * @see isDecomposable
+ */
+ProofResult decomposedSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Prove the expressions are equivalent with a breadth-first search.
+ * Finds a shortest proof, but keeps every visited expression in memory. With
+ * FREEZE_ALIGNED, the search is first run without rewriting the
+ * subexpressions that already equal the rhs, which is much faster for almost
+ * equal expressions but can miss the shortest proof.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+ProofResult breadthFirstSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Prove the expressions are equivalent with an iterative deepening
+ * search. Searches depth-first up to a bound that grows by one step until
+ * MAX_PROOF_LENGTH, so it still finds a shortest proof while only keeping
+ * the current path, its siblings and a small transposition table in memory.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+ProofResult iterativeDeepeningSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Prove the expressions are equivalent with a beam search. Expands
+ * the BEAM_WIDTH expressions closest to the rhs at every step, so time and
+ * memory per step are bounded, but the proof found may not be the shortest
+ * and some proofs are missed.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+ProofResult beamSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Prove the expressions are equivalent by rewriting both into their
+ * canonical disjunctive normal form and joining the lhs steps with the rhs
+ * steps walked backwards. Takes time polynomial in the size of the normal
+ * form, but the proof is usually far from the shortest. Some steps use a law
+ * from right to left.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ *
+ * @see normalize
+ */
+ProofResult normalFormSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Prove the expressions are equivalent by equality saturation. Both
+ * expressions are added to an e-graph, which applies every sound rule of the
+ * equivalences at once until the expressions are in the same e-class, the
+ * e-graph is saturated or it has MAX_EGRAPH_NODES nodes. The proof is read
+ * back from the merges that joined the two e-classes, so it is valid but
+ * usually not the shortest.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ *
+ * @see EGraph
+ */
+ProofResult eGraphSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Shorten a proof by searching for a shorter proof between the ends
+ * of every window of consecutive steps. A window of k steps is replaced if
+ * its ends are at most k - 1 steps apart, and loops through the same
+ * expression are cut out. The proof is kept as far as it was shortened when
+ * the deadline passes or the search is cancelled.
+ *
+ * @param proof the proof to shorten, left as it is unless Proved
+ * @param window maximum number of steps of a window
+ * @param deadline point in time after which the shortening stops
+ * @param cancelled token that stops the shortening once it is set
+ *
+ * @return the proof with the shortened steps and the statistics of the
+ * searches added
+ */
+ProofResult shortenProof(ProofResult proof, int window, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Render the steps of a proof with minimal parentheses. Some laws
+ * only change the parentheses, such as the Associative Law, so steps that
+ * render the same as the step before are dropped.
+ *
+ * @param steps steps of the proof: {{lhs, law},...}
+ *
+ * @return the rendered steps
+ */
+std::vector<std::vector<std::string>> minimizeParentheses(const std::vector<std::vector<std::string>> &steps);
+
+/**
+ * @brief Find the pairs of consecutive steps that occur most often in a
+ * corpus of proofs and register them as macros with EquivLaws::addMacro. A
+ * pair is only counted when the second step rewrites inside or above the
+ * result of the first. Macros are used by the searches once preprocess is
+ * called again.
+ *
+ * @param proofs the proofs, each {{lhs, law},...}
+ * @param count maximum number of macros to register
+ * @param minOccurrences minimum number of times a pair occurs to be registered
+ *
+ * @return number of macros registered
+ */
+int mineMacros(const std::vector<std::vector<std::vector<std::string>>> &proofs, int count, int minOccurrences = 2);
+
+/**
+ * @brief Replace every step of a proof that applies a macro with the steps of
+ * its laws
+ *
+ * @param steps steps of the proof: {{lhs, law},...}
+ *
+ * @return the steps with only primitive laws
+ */
+std::vector<std::vector<std::string>> expandMacros(const std::vector<std::vector<std::string>> &steps);
+
+/**
+ * @brief Get the cost of a step with a law
+ *
+ * @param lawName name of the law
+ *
+ * @return the cost in LAW_COSTS, or DEFAULT_LAW_COST
+ */
+int lawCost(const std::string &lawName);
+
+/**
+ * @brief Prove the expressions are equivalent with a uniform-cost search.
+ * Finds the proof with the lowest total cost of its steps, where every step
+ * costs lawCost of its law. An expression is expanded again if it is reached
+ * more cheaply than before.
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+ProofResult uniformCostSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled);
+
+/**
+ * @brief Get the distance between two expressions used to rank the states
+ * of the beam search. Counts the nodes whose values differ and the nodes
+ * missing from either expression, allowing the operands of every binary
+ * operator to be swapped.
+ *
+ * @param a pointer to the first expression, may be nullptr
+ * @param b pointer to the second expression, may be nullptr
+ *
+ * @return distance, 0 if the expressions are equal up to swapped operands
+ */
+int treeDistance(std::shared_ptr<Expression> a, std::shared_ptr<Expression> b);
+
+/**
+ * @brief Get the subexpression at a position of an expression
+ *
+ * @param root pointer to the root of the expression
+ * @param position path from the root, 'L' for left and 'R' for right
+ *
+ * @return pointer to the subexpression
+ */
+std::shared_ptr<Expression> getSubexpression(std::shared_ptr<Expression> root, const std::string &position);
+
+/**
+ * @brief Find every law that can be applied to the expression or its
+ * subexpressions
  *
  * @param expr pointer to the current expression
+ * @param position path from the root to the current expression
+ * @param matches reference to the vector the matches are appended to in
+ * preorder
+ */
+void findMatches(std::shared_ptr<Expression> expr, std::string position, std::vector<Match> &matches);
+
+/**
+ * @brief Update the matches of an expression after a law was applied at a
+ * position. Only the rewritten subexpression and its ancestors are matched
+ * again, every other match is kept.
+ *
+ * @param matches matches of the expression before the law was applied
+ * @param root pointer to the root of the rewritten expression
+ * @param position path from the root to the rewritten subexpression
+ *
+ * @return vector of the matches of the rewritten expression in preorder
+ */
+std::vector<Match> updateMatches(const std::vector<Match> &matches, std::shared_ptr<Expression> root, const std::string &position);
+
+/**
+ * @brief Get the size and depth an expression would have after applying a
+ * law at a position, without cloning or rewriting anything
+ *
+ * @param root pointer to the root of the expression
+ * @param position path from the root to the subexpression the law is applied to
+ * @param law the equivalence law to apply
+ * @param size reference to the number of nodes of the result
+ * @param depth reference to the number of levels of the result
+ *
+ * @return bool of whether the result could be measured
+ */
+bool measureStep(std::shared_ptr<Expression> root, const std::string &position, EquivLaws::EquivLaw law, int &size, int &depth);
+
+/**
+ * @brief Estimate the bytes used by a state in the queue
+ *
+ * @param state the state in the queue
+ *
+ * @return number of bytes
+ */
+size_t stateMemory(const SearchState &state);
+
+/**
+ * @brief Estimate the bytes used by an entry of the map of visited expressions
+ *
+ * @param exprString string of the visited expression
+ * @param parent pair of the string expression derived from and the law used
+ *
+ * @return number of bytes
+ */
+size_t visitedMemory(const std::string &exprString, const std::pair<std::string, std::string> &parent);
+
+/**
+ * @brief Store a state compactly as the string of its expression
+ *
+ * @param state the state to store
+ *
+ * @return the compact state
+ */
+SearchState compactState(const SearchState &state);
+
+/**
+ * @brief Rebuild the expression and matches of a compact state
+ *
+ * @param state reference to the state to rebuild
+ */
+void expandState(SearchState &state);
+
+/**
+ * @brief Apply a match of a state to a copy of its expression. Matches that
+ * would undo the step that produced the state, or whose result would exceed
+ * MAX_NODES or MAX_DEPTH, are skipped before anything is cloned. Laws are
+ * applied through their compile-time rules, only macros are called through
+ * their function.
+ *
+ * @param state the current state
+ * @param match the match to apply
+ * @param newExpr reference to the pointer the new expression is stored in
+ * @param stats pointer to the statistics the attempt, the success of the law
+ * and a rejection for size are counted in, nullptr to not count them
+ *
+ * @return bool of whether a new expression was created
+ */
+bool applyMatch(const SearchState &state, const Match &match, std::shared_ptr<Expression> &newExpr, SearchStats *stats = nullptr);
+
+/**
+ * @brief Generate the next expressions from the current expression.
+ * Creates a new expression for each match of the current state and adds it
+ * to the queue of steps to be processed if the expression has not already
+ * been visited. New states are stored compactly once the search uses half of
+ * its memory budget.
+ *
+ * @param state the current state
  * @param end pointer to the end expression to reach. If the expression is
  * found, the function will return early.
  * @param found reference to a boolean that is set to true if the end expression
  * is found
- * @param queue reference to the queue of expressions to be for new expressions
+ * @param queue reference to the queue of states to be for new states
  * to be added to
  * @param visited reference to the map of visited expressions.
  * The key is the string representation of the new expression and the value is a
  * pair of the string expression derived from and the law used to get to the
  * expression
+ * @param memory reference to the memory used by the search, new states and
+ * visited expressions are added to it
+ * @param freeze whether to skip the matches inside subexpressions that
+ * already equal the end expression at the same position
+ * @param stats pointer to the statistics the laws tried and the expressions
+ * left out are counted in, nullptr to not count them
+ *
+ * @see findFrozen
+ */
+void generateNextSteps(const SearchState &state, std::shared_ptr<Expression> end, bool &found, std::queue<SearchState> &queue, std::unordered_map<std::string, std::pair<std::string, std::string>> &visited, SearchMemory &memory, bool freeze = false, SearchStats *stats = nullptr);
+
+/**
+ * @brief Find the subexpressions that already equal the subexpression of the
+ * end expression at the same position. Positions are only followed through
+ * operators both expressions share.
+ *
+ * @param expr pointer to the current expression
+ * @param end pointer to the end expression
+ *
+ * @return vector of the paths from the root to the outermost equal
+ * subexpressions, in preorder
  */
-void generateNextSteps(std::shared_ptr<Expression> expr, std::shared_ptr<Expression> end, bool &found, std::queue<std::shared_ptr<Expression>> &queue, std::unordered_map<std::string, std::pair<std::string, std::string>> &visited);
-/** @} */
\ No newline at end of file
+std::vector<std::string> findFrozen(std::shared_ptr<Expression> expr, std::shared_ptr<Expression> end);
+/** @} */
@@ -0,0 +1,171 @@
+/**
+ * @file tracer.h
+ * @brief Header file for tracer class
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Recorder of timed spans in the Chrome trace event format, which
+ * chrome://tracing and Perfetto open as a timeline with a row per thread.
+ * Spans are only recorded between start and stop, and cost a single check
+ * otherwise. Safe to use from several threads.
+ */
+class Tracer {
+public:
+  /**
+   * @brief Start recording spans, forgetting the ones recorded before. The
+   * spans are also written if the program exits before stop is called.
+   *
+   * @param path path to the file the spans are written to by stop
+   */
+  static void start(const std::string &path);
+
+  /**
+   * @brief Stop recording and write the spans to the file given to start
+   *
+   * @return bool of whether the file could be written, false if not
+   * recording
+   */
+  static bool stop();
+
+  /**
+   * @brief Check whether spans are being recorded
+   *
+   * @return bool of whether spans are being recorded
+   */
+  static bool isEnabled();
+
+  /**
+   * @brief Record a span
+   *
+   * @param name name of the span
+   * @param begin point in time the span began
+   * @param end point in time the span ended
+   * @param args numbers shown with the span
+   */
+  static void record(const std::string &name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, const std::map<std::string, double> &args = {});
+
+  /**
+   * @brief Render the recorded spans as a trace file
+   *
+   * @return the JSON object of the trace
+   */
+  static std::string toJson();
+
+private:
+  /**
+   * @brief Span recorded
+   */
+  struct Event {
+    /**
+     * @brief Name of the span
+     */
+    std::string name;
+
+    /**
+     * @brief Microseconds from the start of the recording to the span
+     */
+    long long begin;
+
+    /**
+     * @brief Length of the span in microseconds
+     */
+    long long duration;
+
+    /**
+     * @brief Number of the thread of the span, in the order threads first
+     * recorded a span
+     */
+    int thread;
+
+    /**
+     * @brief Numbers shown with the span
+     */
+    std::map<std::string, double> args;
+  };
+
+  /**
+   * @brief Whether spans are being recorded, read without the lock
+   */
+  static std::atomic<bool> enabled;
+
+  /**
+   * @brief Path to the file the spans are written to
+   */
+  static std::string path;
+
+  /**
+   * @brief Point in time the recording started
+   */
+  static std::chrono::steady_clock::time_point origin;
+
+  /**
+   * @brief Spans recorded so far
+   */
+  static std::vector<Event> events;
+
+  /**
+   * @brief Map of threads to their numbers
+   */
+  static std::map<std::thread::id, int> threads;
+
+  /**
+   * @brief Lock held while touching any of the above but enabled
+   */
+  static std::mutex lock;
+};
+
+/**
+ * @brief Span recorded from its construction to its destruction, for timing
+ * a scope
+ */
+class TraceSpan {
+public:
+  /**
+   * @brief Begin a span
+   *
+   * @param name name of the span
+   */
+  explicit TraceSpan(const std::string &name);
+
+  /**
+   * @brief End the span and record it
+   */
+  ~TraceSpan();
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+  /**
+   * @brief Set a number shown with the span
+   *
+   * @param key name of the number
+   * @param value the number
+   */
+  void setArg(const std::string &key, double value);
+
+private:
+  /**
+   * @brief Name of the span, empty if spans were not recorded when it began
+   */
+  std::string name;
+
+  /**
+   * @brief Point in time the span began
+   */
+  std::chrono::steady_clock::time_point begin;
+
+  /**
+   * @brief Numbers shown with the span
+   */
+  std::map<std::string, double> args;
+};
@@ -6,16 +6,73 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <thread>
 
+#include "include/batch.h"
 #include "include/evaluator.h"
 #include "include/parser.h"
+#include "include/proofCache.h"
 #include "include/solver.h"
+#include "include/tracer.h"
 
 #define SUCCESS "[\033[32m+\033[0m] "
 #define FAILURE "[\033[31m-\033[0m] "
 #define ALERT "[\033[33m!\033[0m] "
 
-int main() {
+/**
+ * @brief Print the statistics of a search
+ *
+ * @param stats the statistics
+ */
+static void printStats(const SearchStats &stats) {
+  std::cout << ALERT << "Search statistics:" << std::endl;
+  std::cout << "  Expanded: " << stats.expanded << ", generated: " << stats.generated
+            << ", duplicates: " << stats.duplicates << ", too large: " << stats.lengthRejected << std::endl;
+  std::cout << "  Peak memory: " << stats.peakMemory / 1024 << " KB, peak visited: " << stats.peakVisited << std::endl;
+  std::cout << "  Frontier by depth:";
+  for (int size : stats.frontier)
+    std::cout << " " << size;
+  std::cout << std::endl;
+  for (auto law : stats.lawAttempts) {
+    auto successes = stats.lawSuccesses.find(law.first);
+    std::cout << "  " << law.first << ": " << (successes == stats.lawSuccesses.end() ? 0 : successes->second)
+              << " of " << law.second << " attempts" << std::endl;
+  }
+  for (auto phase : stats.phaseSeconds)
+    std::cout << "  " << phase.first << ": " << phase.second << " s" << std::endl;
+  std::cout << "  Total: " << stats.seconds << " s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  // --batch [path] proves every pair of a file, or of the input without a
+  // path, and writes JSON Lines
+  bool batch = false;
+  std::string batchPath;
+  int threads = std::thread::hardware_concurrency();
+  double timeout = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--batch") {
+      batch = true;
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+        batchPath = argv[++i];
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::stoi(argv[++i]);
+    } else if (arg == "--timeout" && i + 1 < argc) {
+      timeout = std::stod(argv[++i]);
+    } else {
+      std::cout << "Usage: " << argv[0] << " [--batch [path]] [--threads <count>] [--timeout <seconds>]" << std::endl;
+      return 1;
+    }
+  }
+
+  // in batch mode the output is only the results, everything else goes to
+  // the error stream
+  std::streambuf *output = std::cout.rdbuf();
+  if (batch)
+    std::cout.rdbuf(std::cerr.rdbuf());
+
   std::cout << R"(  _              ___  __         
  | |   ___  __ _(_) \/ /_ __ _ _ 
  | |__/ _ \/ _` | |>  <| '_ \ '_|
@@ -34,28 +91,158 @@ int main() {
 
   // read config.ini
   std::string line;
-  int maxQueueSize = 0;
-  int maxExprLength = 0;
+  int maxMemoryMb = 0;
+  int maxNodes = 0;
+  int maxDepth = 0;
+  int maxProofLength = 0;
+  int beamWidth = 0;
+  int defaultLawCost = 0;
+  int maxEGraphNodes = 0;
+  int shortenWindow = -1;
+  int freezeAligned = -1;
+  int proofTemplatesOn = -1;
+  std::string proofCachePath;
+  std::string distanceTablePath;
+  int macroRules = -1;
+  int showStats = -1;
+  std::string statsPath;
+  std::string tracePath;
+  std::unordered_map<std::string, int> lawCosts;
+  bool badLawCost = false;
+  std::string searchMode = "bfs";
   while (std::getline(configFile, line)) {
-    if (line.find("MAX_QUEUE_SIZE") != std::string::npos) {
-      maxQueueSize = std::stoi(line.substr(line.find("=") + 1));
-    } else if (line.find("MAX_EXPRESSION_LENGTH") != std::string::npos) {
-      maxExprLength = std::stoi(line.substr(line.find("=") + 1));
+    if (line.find("MAX_MEMORY_MB") != std::string::npos) {
+      maxMemoryMb = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("MAX_EGRAPH_NODES") != std::string::npos) {
+      maxEGraphNodes = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("SHORTEN_WINDOW") != std::string::npos) {
+      shortenWindow = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("FREEZE_ALIGNED") != std::string::npos) {
+      freezeAligned = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("PROOF_TEMPLATES") != std::string::npos) {
+      proofTemplatesOn = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("SHOW_STATS") != std::string::npos) {
+      showStats = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("STATS_JSON") != std::string::npos) {
+      statsPath = line.substr(line.find("=") + 1);
+    } else if (line.find("TRACE_FILE") != std::string::npos) {
+      tracePath = line.substr(line.find("=") + 1);
+    } else if (line.find("MACRO_RULES") != std::string::npos) {
+      macroRules = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("DISTANCE_TABLE") != std::string::npos) {
+      distanceTablePath = line.substr(line.find("=") + 1);
+    } else if (line.find("PROOF_CACHE") != std::string::npos) {
+      proofCachePath = line.substr(line.find("=") + 1);
+    } else if (line.find("MAX_NODES") != std::string::npos) {
+      maxNodes = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("MAX_DEPTH") != std::string::npos) {
+      maxDepth = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("MAX_PROOF_LENGTH") != std::string::npos) {
+      maxProofLength = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("BEAM_WIDTH") != std::string::npos) {
+      beamWidth = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("DEFAULT_LAW_COST") != std::string::npos) {
+      defaultLawCost = std::stoi(line.substr(line.find("=") + 1));
+    } else if (line.find("LAW_COST") != std::string::npos) {
+      // LAW_COST=<law name>,<cost>
+      std::string lawCost = line.substr(line.find("=") + 1);
+      if (lawCost.find(",") == std::string::npos) {
+        badLawCost = true;
+        continue;
+      }
+      int cost = std::stoi(lawCost.substr(lawCost.rfind(",") + 1));
+      badLawCost = badLawCost || cost < 0;
+      lawCosts[lawCost.substr(0, lawCost.rfind(","))] = cost;
+    } else if (line.find("SEARCH_MODE") != std::string::npos) {
+      searchMode = line.substr(line.find("=") + 1);
     }
   }
 
   // check if config.ini is valid
-  if (maxQueueSize <= 0 || maxExprLength <= 0) {
+  if (maxMemoryMb <= 0 || maxNodes <= 0 || maxDepth <= 0 ||
+      maxProofLength <= 0 || beamWidth <= 0 || defaultLawCost < 0 ||
+      badLawCost || maxEGraphNodes <= 0 || shortenWindow < 0 ||
+      (freezeAligned != 0 && freezeAligned != 1) ||
+      (proofTemplatesOn != 0 && proofTemplatesOn != 1) || macroRules < 0 ||
+      (showStats != 0 && showStats != 1) ||
+      (searchMode != "bfs" && searchMode != "iddfs" && searchMode != "beam" &&
+       searchMode != "ucs" && searchMode != "nf" && searchMode != "egraph")) {
     std::cout << FAILURE << "config.ini has bad values!" << std::endl;
     return 1;
   }
 
   std::cout << SUCCESS << "Read config.ini successfully!" << std::endl;
-  std::cout << ALERT << "Setting config values... (" << maxQueueSize << "," << maxExprLength << ")" << std::endl;
+  std::cout << ALERT << "Setting config values... (" << maxMemoryMb << "," << maxNodes << "," << maxDepth << "," << maxProofLength << "," << beamWidth << "," << searchMode << ")" << std::endl;
 
   // set config values
-  MAX_QUEUE_SIZE = maxQueueSize;
-  MAX_EXPRESSION_LENGTH = maxExprLength;
+  MAX_MEMORY_MB = maxMemoryMb;
+  MAX_NODES = maxNodes;
+  MAX_DEPTH = maxDepth;
+  MAX_PROOF_LENGTH = maxProofLength;
+  BEAM_WIDTH = beamWidth;
+  DEFAULT_LAW_COST = defaultLawCost;
+  LAW_COSTS = lawCosts;
+  MAX_EGRAPH_NODES = maxEGraphNodes;
+  SHORTEN_WINDOW = shortenWindow;
+  FREEZE_ALIGNED = freezeAligned == 1;
+  USE_TEMPLATES = proofTemplatesOn == 1;
+  if (searchMode == "iddfs")
+    SEARCH_MODE = SearchMode::IterativeDeepening;
+  else if (searchMode == "beam")
+    SEARCH_MODE = SearchMode::Beam;
+  else if (searchMode == "ucs")
+    SEARCH_MODE = SearchMode::UniformCost;
+  else if (searchMode == "nf")
+    SEARCH_MODE = SearchMode::NormalForm;
+  else if (searchMode == "egraph")
+    SEARCH_MODE = SearchMode::EGraph;
+  else
+    SEARCH_MODE = SearchMode::BreadthFirst;
+
+  if (!tracePath.empty())
+    Tracer::start(tracePath);
+
+  ProofCache proofCache;
+  if (!proofCachePath.empty()) {
+    TraceSpan span("Load Proof Cache");
+    std::cout << ALERT << "Loading proof cache..." << std::endl;
+    if (proofCache.open(proofCachePath))
+      std::cout << SUCCESS << "Loaded " << proofCache.size() << " cached proofs!" << std::endl;
+    else
+      std::cout << FAILURE << "Couldn't open the proof cache, proving without it" << std::endl;
+  }
+
+  if (macroRules > 0 && proofCache.size() > 0) {
+    TraceSpan span("Learn Macro Rules");
+    std::cout << ALERT << "Learning macro rules..." << std::endl;
+    std::cout << SUCCESS << "Learned " << mineMacros(proofCache.proofs(), macroRules) << " macro rules!" << std::endl;
+  }
+
+  if (!distanceTablePath.empty()) {
+    TraceSpan span("Load Distance Table");
+    std::cout << ALERT << "Loading distance table..." << std::endl;
+    if (distanceTable.open(distanceTablePath))
+      std::cout << SUCCESS << "Loaded the distance table of " << distanceTable.size() << " expressions!" << std::endl;
+    else
+      std::cout << FAILURE << "Couldn't open the distance table, proving without it" << std::endl;
+  }
+
+  if (batch) {
+    std::ifstream batchFile(batchPath);
+    if (!batchPath.empty() && !batchFile.good()) {
+      std::cout << FAILURE << "Couldn't open " << batchPath << " :(" << std::endl;
+      return 1;
+    }
+    std::cout << ALERT << "Proving pairs on " << std::max(threads, 1) << " threads..." << std::endl;
+    std::ostream results(output);
+    int pairs = proveBatch(batchPath.empty() ? std::cin : batchFile, results, threads, timeout, proofCachePath.empty() ? nullptr : &proofCache);
+    std::cout << SUCCESS << "Wrote the results of " << pairs << " pairs!" << std::endl;
+
+    if (!tracePath.empty() && !Tracer::stop())
+      std::cout << FAILURE << "Couldn't write the trace to " << tracePath << std::endl;
+    std::cout.rdbuf(output);
+    return 0;
+  }
 
   std::string lhs;
   std::string rhs;
@@ -65,6 +252,7 @@ int main() {
   std::cout << ALERT << "Enter the ending logical expression: ";
   std::getline(std::cin, rhs);
 
+  std::unique_ptr<TraceSpan> parseSpan(new TraceSpan("Parse"));
   std::cout << ALERT << "Parsing expressions..." << std::endl;
 
   std::shared_ptr<Expression> lhsTree;
@@ -115,9 +303,15 @@ int main() {
               << std::endl;
     return 1;
   }
+  parseSpan.reset();
 
   std::cout << ALERT << "Checking equivalence..." << std::endl;
-  if (isEquivalent(lhsTree, rhsTree)) {
+  bool equivalent;
+  {
+    TraceSpan span("Check Equivalence");
+    equivalent = isEquivalent(lhsTree, rhsTree);
+  }
+  if (equivalent) {
     std::cout << SUCCESS << "Expressions are equivalent!" << std::endl;
   } else {
     std::cout << FAILURE << "Expressions are not equivalent :(" << std::endl;
@@ -131,40 +325,53 @@ int main() {
   std::cout
       << "===================================================================="
       << std::endl;
-  std::vector<std::vector<std::string>> steps =
-      proveEquivalence(lhsTree, rhsTree);
+  // proofs found before are read back from the cache file, which stores
+  // them with renamed variables so every renaming of a problem shares them
+  std::unordered_map<std::string, std::string> renaming = getRenaming(lhsTree, rhsTree);
+  std::shared_ptr<Expression> renamedLhs = renameVariables(lhsTree, renaming);
+  std::shared_ptr<Expression> renamedRhs = renameVariables(rhsTree, renaming);
+  std::vector<std::vector<std::string>> steps;
+  SearchStats stats;
+  if (proofCache.find(renamedLhs, renamedRhs, steps)) {
+    steps = renameSteps(steps, invertRenaming(renaming));
+  } else {
+    // macros are expanded before caching, so cached proofs only use the laws
+    steps = expandMacros(proveEquivalence(lhsTree, rhsTree, stats));
+    if (steps.back()[0] != "")
+      proofCache.insert(renamedLhs, renamedRhs, renameSteps(steps, renaming));
+  }
+
+  if (showStats == 1)
+    printStats(stats);
+  if (!statsPath.empty()) {
+    std::ofstream statsFile(statsPath);
+    statsFile << statsToJson(stats) << std::endl;
+    if (!statsFile.good())
+      std::cout << FAILURE << "Couldn't write the statistics to " << statsPath << std::endl;
+  }
 
   // process the steps to make it aesthetically pleasing
+  std::unique_ptr<TraceSpan> outputSpan(new TraceSpan("Output"));
   std::vector<std::vector<std::string>> processedSteps;
   int longestStrLen = 0;
   // check if the last step is not "Too many steps :("
   if (steps.back()[1] == "Too many steps :(") {
-    std::cout << FAILURE << "Too many in queue :(. " << std::endl;
-    std::cout << ALERT << "Tweak config ini by reducing logical expression length or increasing queue size" << std::endl;
+    std::cout << FAILURE << "Ran out of memory :(. " << std::endl;
+    std::cout << ALERT << "Tweak config ini by reducing max nodes and depth or increasing max memory" << std::endl;
     return 1;
   }
   else if (steps.back()[1] == "Couldn't find a solution :(") {
     // check if the last step is not "Couldn't find a solution :("
     std::cout << FAILURE << "Couldn't find a solution :(. " << std::endl;
-    std::cout << ALERT << "Tweak config ini by reducing logical expression length or increasing queue size" << std::endl;
+    std::cout << ALERT << "Tweak config ini by increasing max nodes and depth or increasing max memory" << std::endl;
     return 1;
   }
   else {
-    for (auto step : steps) {
-    std::shared_ptr<Expression> currentStep;
-    parse(step[0], currentStep);
-    std::string processedStr = currentStep->toStringMinimal();
-    if (processedStr.length() > longestStrLen) {
-      longestStrLen = processedStr.length();
-    }
-
-    // sometimes, the laws don't actually change the expression once
-    // unnecessary parentheses are removed, so we need to check for that
-    if (processedSteps.size() == 0)
-      processedSteps.push_back({processedStr, step[1]});
-    else if (processedSteps.size() > 0 &&
-             processedSteps.back()[0] != processedStr)
-      processedSteps.push_back({processedStr, step[1]});
+    processedSteps = minimizeParentheses(steps);
+    for (auto step : processedSteps) {
+      if ((int)step[0].length() > longestStrLen) {
+        longestStrLen = step[0].length();
+      }
     }
   }
 
@@ -188,6 +395,9 @@ int main() {
   std::cout
       << "===================================================================="
       << std::endl;
+  outputSpan.reset();
 
+  if (!tracePath.empty() && !Tracer::stop())
+    std::cout << FAILURE << "Couldn't write the trace to " << tracePath << std::endl;
   return 0;
 }
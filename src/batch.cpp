@@ -0,0 +1,263 @@
+/**
+ * @file batch.cpp
+ * @brief Implementation file for batch functions
+ */
+
+#include "../include/batch.h"
+#include "../include/evaluator.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include "../include/tracer.h"
+#include <functional>
+#include <map>
+#include <sstream>
+#include <thread>
+
+/**
+ * @brief Pair of expressions of a batch and its result
+ */
+struct BatchPair {
+  /**
+   * @brief Number of the line the pair was read from
+   */
+  int line = 0;
+
+  /**
+   * @brief Left hand side as read
+   */
+  std::string lhsString;
+
+  /**
+   * @brief Right hand side as read
+   */
+  std::string rhsString;
+
+  /**
+   * @brief Parsed left hand side, nullptr if invalid
+   */
+  std::shared_ptr<Expression> lhs = nullptr;
+
+  /**
+   * @brief Parsed right hand side, nullptr if invalid
+   */
+  std::shared_ptr<Expression> rhs = nullptr;
+
+  /**
+   * @brief Status of the pair, empty until known
+   */
+  std::string status = "";
+
+  /**
+   * @brief Steps of the proof if proved
+   */
+  std::vector<std::vector<std::string>> steps = {};
+
+  /**
+   * @brief Seconds spent on the pair
+   */
+  double seconds = 0;
+};
+
+/**
+ * @brief Remove the spaces around a string
+ *
+ * @param str the string
+ *
+ * @return the string without leading and trailing spaces
+ */
+static std::string trim(const std::string &str)
+{
+  size_t begin = str.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return "";
+  return str.substr(begin, str.find_last_not_of(" \t\r") - begin + 1);
+}
+
+/**
+ * @brief Run a function for every index up to a count on several threads
+ *
+ * @param count number of indices
+ * @param threads number of threads
+ * @param run the function, called with every index once
+ */
+static void runParallel(int count, int threads, const std::function<void(int)> &run)
+{
+  std::atomic<int> next(0);
+  auto work = [&]()
+  {
+    for (int i = next++; i < count; i = next++)
+      run(i);
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 1; i < std::min(threads, count); i++)
+    workers.emplace_back(work);
+  work();
+  for (std::thread &worker : workers)
+    worker.join();
+}
+
+/**
+ * @brief Parse and check a pair, and look it up in the cache
+ *
+ * @param pair the pair
+ * @param cache proofs reused, none if nullptr
+ */
+static void checkPair(BatchPair &pair, ProofCache *cache)
+{
+  if (!pair.status.empty())
+    return;
+  TraceSpan span("Check Pair");
+  auto startTime = std::chrono::steady_clock::now();
+
+  // parsed twice to drop unnecessary parentheses, like the interactive mode
+  if (!parse(pair.lhsString, pair.lhs) || !parse(pair.lhs->toStringTree(), pair.lhs) ||
+      !parse(pair.rhsString, pair.rhs) || !parse(pair.rhs->toStringTree(), pair.rhs))
+    pair.status = "invalid";
+  else if (!isEquivalent(pair.lhs, pair.rhs))
+    pair.status = "not equivalent";
+  else if (cache)
+  {
+    std::unordered_map<std::string, std::string> renaming = getRenaming(pair.lhs, pair.rhs);
+    if (cache->find(renameVariables(pair.lhs, renaming), renameVariables(pair.rhs, renaming), pair.steps))
+    {
+      pair.steps = renameSteps(pair.steps, invertRenaming(renaming));
+      pair.status = "proved";
+    }
+  }
+  pair.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief Prove a pair with the laws picked by preprocess, and add the proof
+ * to the cache
+ *
+ * @param pair the pair
+ * @param seconds time limit, none if 0
+ * @param cache proofs added to, none if nullptr
+ */
+static void provePair(BatchPair &pair, double seconds, ProofCache *cache)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  auto deadline = seconds > 0 ? startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds))
+                              : std::chrono::steady_clock::time_point::max();
+  std::atomic<bool> cancelled(false);
+  ProofResult result = proveEquivalence(pair.lhs, pair.rhs, deadline, cancelled);
+
+  if (result.status == ProofStatus::Proved)
+  {
+    // macros are expanded before caching, so cached proofs only use the laws
+    pair.status = "proved";
+    pair.steps = expandMacros(result.steps);
+    if (cache)
+    {
+      std::unordered_map<std::string, std::string> renaming = getRenaming(pair.lhs, pair.rhs);
+      cache->insert(renameVariables(pair.lhs, renaming), renameVariables(pair.rhs, renaming), renameSteps(pair.steps, renaming));
+    }
+  }
+  else if (result.status == ProofStatus::OutOfMemory)
+    pair.status = "out of memory";
+  else if (result.status == ProofStatus::TimedOut)
+    pair.status = "timed out";
+  else
+    pair.status = "not found";
+  pair.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/**
+ * @brief Render the result of a pair as a line of JSON
+ *
+ * @param pair the pair
+ *
+ * @return the JSON object on a single line
+ */
+static std::string pairToJson(const BatchPair &pair)
+{
+  std::ostringstream json;
+  json << "{\"line\":" << pair.line << ",\"lhs\":" << jsonString(pair.lhsString) << ",\"rhs\":" << jsonString(pair.rhsString)
+       << ",\"status\":" << jsonString(pair.status);
+  if (pair.status == "proved")
+  {
+    std::vector<std::vector<std::string>> steps = minimizeParentheses(pair.steps);
+    json << ",\"steps\":[";
+    for (size_t i = 0; i < steps.size(); i++)
+      json << (i == 0 ? "" : ",") << "{\"expression\":" << jsonString(steps[i][0]) << ",\"law\":" << jsonString(steps[i][1]) << "}";
+    json << "]";
+  }
+  json << ",\"seconds\":" << pair.seconds << "}";
+  return json.str();
+}
+
+/**
+ * @brief Prove a window of pairs and write their results
+ *
+ * @param pairs the pairs, in the order they were read
+ * @param output stream the results are written to
+ * @param threads number of pairs proved at once
+ * @param seconds time limit of every pair, none if 0
+ * @param cache proofs reused and added to, none if nullptr
+ */
+static void proveWindow(std::vector<BatchPair> &pairs, std::ostream &output, int threads, double seconds, ProofCache *cache)
+{
+  runParallel(pairs.size(), threads, [&](int i)
+              { checkPair(pairs[i], cache); });
+
+  // the laws preprocess picks only depend on which of -> and <=> appear
+  std::map<std::pair<bool, bool>, std::vector<int>> groups;
+  for (size_t i = 0; i < pairs.size(); i++)
+  {
+    if (!pairs[i].status.empty())
+      continue;
+    std::string both = pairs[i].lhs->toStringTree() + " " + pairs[i].rhs->toStringTree();
+    groups[{both.find(IMPLIES) != std::string::npos, both.find(IFF) != std::string::npos}].push_back(i);
+  }
+
+  for (auto &group : groups)
+  {
+    std::vector<int> &indices = group.second;
+    preprocess(pairs[indices[0]].lhs, pairs[indices[0]].rhs);
+    runParallel(indices.size(), threads, [&](int i)
+                { provePair(pairs[indices[i]], seconds, cache); });
+  }
+
+  TraceSpan span("Write Results");
+  for (const BatchPair &pair : pairs)
+    output << pairToJson(pair) << "\n";
+  output.flush();
+}
+
+int proveBatch(std::istream &input, std::ostream &output, int threads, double seconds, ProofCache *cache)
+{
+  threads = std::max(threads, 1);
+
+  // the pairs already keep the threads busy, decomposed searches only get
+  // the threads left over
+  int decompositionThreads = MAX_DECOMPOSITION_THREADS;
+  MAX_DECOMPOSITION_THREADS = std::max(decompositionThreads - threads, 0);
+
+  int count = 0;
+  std::vector<BatchPair> pairs;
+  std::string line;
+  for (int number = 1; std::getline(input, line); number++)
+  {
+    if (trim(line).empty() || line[0] == '#')
+      continue;
+
+    size_t separator = line.find(';');
+    BatchPair pair = {number, trim(line.substr(0, separator)), separator == std::string::npos ? "" : trim(line.substr(separator + 1))};
+    if (separator == std::string::npos)
+      pair.status = "invalid";
+    pairs.push_back(pair);
+    count++;
+
+    if (pairs.size() == BATCH_WINDOW)
+    {
+      proveWindow(pairs, output, threads, seconds, cache);
+      pairs.clear();
+    }
+  }
+  if (!pairs.empty())
+    proveWindow(pairs, output, threads, seconds, cache);
+  MAX_DECOMPOSITION_THREADS = decompositionThreads;
+  return count;
+}
@@ -0,0 +1,519 @@
+/**
+ * @file distanceTable.cpp
+ * @brief Implementation file for distance table class
+ */
+
+#include "../include/distanceTable.h"
+#include "../include/solver.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <queue>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief First bytes of every distance table file
+ */
+static const std::string MAGIC = "LOGIXPR-DISTANCES-1\n";
+
+/**
+ * @brief Number of bytes of a record in the file
+ */
+static const size_t RECORD_SIZE = sizeof(uint64_t) + 2 * sizeof(uint32_t) + 2 * sizeof(uint16_t);
+
+/**
+ * @brief Index of an expression without a step
+ */
+static const uint32_t NONE = 0xFFFFFFFF;
+
+/**
+ * @brief Symbols of the nodes, indexed by their 4-bit code. Codes after the
+ * last symbol are the variables from a, and 0 ends a key.
+ */
+static const std::vector<std::string> SYMBOLS = {"", AND, OR, NOT, XOR, IMPLIES, IFF, TRUE, FALSE};
+
+/**
+ * @brief Maximum number of nodes of a key
+ */
+static const int MAX_KEY_NODES = 16;
+
+/**
+ * @brief Maximum number of variables of a key
+ */
+static const int MAX_KEY_VARIABLES = 16 - SYMBOLS.size();
+
+/**
+ * @brief Evaluate the expression of a key
+ *
+ * @param key reference to the key, the symbols evaluated are shifted out
+ * @param assignment bit i is the value of the i-th variable
+ *
+ * @return value of the expression
+ */
+static bool evaluateKey(uint64_t &key, int assignment)
+{
+  int code = key & 0xF;
+  key >>= 4;
+  if (code >= (int)SYMBOLS.size())
+    return (assignment >> (code - SYMBOLS.size())) & 1;
+
+  std::string symbol = SYMBOLS[code];
+  if (symbol == TRUE || symbol == FALSE)
+    return symbol == TRUE;
+  bool left = evaluateKey(key, assignment);
+  if (symbol == NOT)
+    return !left;
+  bool right = evaluateKey(key, assignment);
+  if (symbol == AND)
+    return left && right;
+  if (symbol == OR)
+    return left || right;
+  if (symbol == XOR)
+    return left != right;
+  if (symbol == IMPLIES)
+    return !left || right;
+  return left == right;
+}
+
+/**
+ * @brief Build the expression of a key
+ *
+ * @param key reference to the key, the symbols decoded are shifted out
+ *
+ * @return pointer to the expression
+ */
+static std::shared_ptr<Expression> decodeKey(uint64_t &key)
+{
+  int code = key & 0xF;
+  key >>= 4;
+  if (code >= (int)SYMBOLS.size())
+    return std::make_shared<Expression>(std::string(1, 'a' + code - SYMBOLS.size()));
+
+  std::shared_ptr<Expression> expression = std::make_shared<Expression>(SYMBOLS[code]);
+  if (SYMBOLS[code] == TRUE || SYMBOLS[code] == FALSE)
+    return expression;
+  expression->setLeft(decodeKey(key), expression);
+  if (SYMBOLS[code] != NOT)
+    expression->setRight(decodeKey(key), expression);
+  return expression;
+}
+
+/**
+ * @brief Collect the paths of every subexpression a law can apply to
+ *
+ * @param expr pointer to the current subexpression
+ * @param position path from the root to the subexpression
+ * @param positions reference to the vector the paths are stored in
+ */
+static void collectPositions(std::shared_ptr<Expression> expr, const std::string &position, std::vector<std::string> &positions)
+{
+  if (expr->isVar())
+    return;
+  positions.push_back(position);
+  if (expr->hasLeft())
+    collectPositions(expr->getLeft(), position + "L", positions);
+  if (expr->hasRight())
+    collectPositions(expr->getRight(), position + "R", positions);
+}
+
+/**
+ * @brief Write an integer to a file
+ *
+ * @param file reference to the file
+ * @param value the integer
+ */
+template <typename T>
+static void writeValue(std::ofstream &file, T value)
+{
+  file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+DistanceTable::DistanceTable() : mapped(nullptr), mappedSize(0), records(nullptr), variables(0), count(0)
+{
+}
+
+DistanceTable::~DistanceTable()
+{
+  this->close();
+}
+
+bool DistanceTable::build(const std::string &path, int maxNodes, int variables)
+{
+  if (maxNodes < 1 || maxNodes > MAX_KEY_NODES || variables < 1 || variables > std::min(MAX_KEY_VARIABLES, 5))
+    return false;
+
+  // every expression by its number of nodes, built from smaller ones
+  std::vector<std::vector<uint64_t>> bySize(maxNodes + 1);
+  for (int code = 7; code < (int)SYMBOLS.size() + variables; code++)
+    bySize[1].push_back(code);
+  for (int size = 2; size <= maxNodes; size++)
+  {
+    for (uint64_t child : bySize[size - 1])
+      bySize[size].push_back(3 | child << 4);
+    for (int code : {1, 2, 4, 5, 6})
+    {
+      for (int leftSize = 1; leftSize < size - 1; leftSize++)
+      {
+        for (uint64_t left : bySize[leftSize])
+        {
+          for (uint64_t right : bySize[size - 1 - leftSize])
+            bySize[size].push_back(code | left << 4 | right << (4 * (leftSize + 1)));
+        }
+      }
+    }
+  }
+
+  std::vector<uint64_t> keys;
+  for (auto &sized : bySize)
+    keys.insert(keys.end(), sized.begin(), sized.end());
+  std::sort(keys.begin(), keys.end());
+  auto indexOf = [&](uint64_t key)
+  {
+    auto found = std::lower_bound(keys.begin(), keys.end(), key);
+    return found != keys.end() && *found == key ? uint32_t(found - keys.begin()) : NONE;
+  };
+
+  // every law, numbered in the order of their names
+  std::unordered_map<EquivLaws::EquivLaw, std::string> laws = EquivLaws::laws;
+  laws.insert(EquivLaws::implications.begin(), EquivLaws::implications.end());
+  laws.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
+  std::map<std::string, uint16_t> lawIds;
+  for (auto law : laws)
+    lawIds[law.second] = 0;
+  std::vector<std::string> lawNames;
+  for (auto &law : lawIds)
+  {
+    law.second = lawNames.size();
+    lawNames.push_back(law.first);
+  }
+  LawIndex index;
+  index.insert(laws);
+
+  // every step between two expressions of the table
+  std::vector<std::vector<std::pair<uint32_t, uint16_t>>> forward(keys.size());
+  std::vector<std::vector<std::pair<uint32_t, uint16_t>>> backward(keys.size());
+  for (uint32_t i = 0; i < keys.size(); i++)
+  {
+    std::shared_ptr<Expression> expr = decode(keys[i]);
+    std::vector<std::string> positions;
+    collectPositions(expr, "", positions);
+    for (auto &position : positions)
+    {
+      for (auto law : index.match(getSubexpression(expr, position)))
+      {
+        std::shared_ptr<Expression> newExpr = expr->clone();
+        std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, position);
+        if (!law(subexpression))
+          continue;
+        if (position.empty())
+          newExpr = subexpression;
+
+        uint64_t key;
+        if (!encode(newExpr, variables, key))
+          continue;
+        uint32_t next = indexOf(key);
+        if (next == NONE || next == i)
+          continue;
+        forward[i].push_back({next, lawIds[laws[law]]});
+        backward[next].push_back({i, lawIds[laws[law]]});
+      }
+    }
+  }
+
+  // the canonical expression of a truth table is the first one enumerated
+  std::unordered_map<uint32_t, uint32_t> canonical;
+  for (auto &sized : bySize)
+  {
+    for (uint64_t key : sized)
+    {
+      uint32_t table = 0;
+      for (int assignment = 0; assignment < (1 << variables); assignment++)
+      {
+        uint64_t rest = key;
+        table |= uint32_t(evaluateKey(rest, assignment)) << assignment;
+      }
+      canonical.insert({table, indexOf(key)});
+    }
+  }
+
+  // shortest paths to every canonical expression and back out of it
+  std::vector<Record> table(keys.size(), {0, NONE, NONE, 0, 0});
+  for (uint32_t i = 0; i < keys.size(); i++)
+    table[i].key = keys[i];
+  for (auto &root : canonical)
+  {
+    table[root.second].toward = root.second;
+    table[root.second].from = root.second;
+
+    std::queue<uint32_t> queue;
+    queue.push(root.second);
+    while (!queue.empty())
+    {
+      uint32_t current = queue.front();
+      queue.pop();
+      for (auto step : backward[current])
+      {
+        if (table[step.first].toward != NONE)
+          continue;
+        table[step.first].toward = current;
+        table[step.first].towardLaw = step.second;
+        queue.push(step.first);
+      }
+    }
+
+    queue.push(root.second);
+    while (!queue.empty())
+    {
+      uint32_t current = queue.front();
+      queue.pop();
+      for (auto step : forward[current])
+      {
+        if (table[step.first].from != NONE)
+          continue;
+        table[step.first].from = current;
+        table[step.first].fromLaw = step.second;
+        queue.push(step.first);
+      }
+    }
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file << MAGIC;
+  writeValue<uint32_t>(file, maxNodes);
+  writeValue<uint32_t>(file, variables);
+  writeValue<uint32_t>(file, lawNames.size());
+  writeValue<uint32_t>(file, keys.size());
+  for (auto &name : lawNames)
+  {
+    writeValue<uint32_t>(file, name.size());
+    file << name;
+  }
+  for (auto &record : table)
+  {
+    writeValue(file, record.key);
+    writeValue(file, record.toward);
+    writeValue(file, record.from);
+    writeValue(file, record.towardLaw);
+    writeValue(file, record.fromLaw);
+  }
+  return file.good();
+}
+
+bool DistanceTable::open(const std::string &path)
+{
+  this->close();
+
+#ifndef _WIN32
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0)
+    return false;
+  struct stat status;
+  if (fstat(descriptor, &status) != 0)
+  {
+    ::close(descriptor);
+    return false;
+  }
+  this->mappedSize = status.st_size;
+  void *memory = this->mappedSize > 0 ? mmap(nullptr, this->mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+  ::close(descriptor);
+  if (memory == MAP_FAILED)
+  {
+    this->mappedSize = 0;
+    return false;
+  }
+  this->mapped = static_cast<const char *>(memory);
+#else
+  // without mmap, read the whole file into memory instead
+  std::ifstream file(path, std::ios::binary);
+  if (!file.good())
+    return false;
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  this->mappedSize = contents.size();
+  char *memory = new char[this->mappedSize];
+  std::memcpy(memory, contents.data(), this->mappedSize);
+  this->mapped = memory;
+#endif
+
+  // the header, then the law names, then exactly the records it announces
+  uint32_t header[4];
+  size_t offset = MAGIC.size() + sizeof(header);
+  if (this->mappedSize < offset || std::memcmp(this->mapped, MAGIC.data(), MAGIC.size()) != 0)
+  {
+    this->close();
+    return false;
+  }
+  std::memcpy(header, this->mapped + MAGIC.size(), sizeof(header));
+  for (uint32_t i = 0; i < header[2]; i++)
+  {
+    uint32_t length;
+    if (offset + sizeof(length) > this->mappedSize)
+      break;
+    std::memcpy(&length, this->mapped + offset, sizeof(length));
+    offset += sizeof(length);
+    if (offset + length > this->mappedSize)
+      break;
+    this->lawNames.push_back(std::string(this->mapped + offset, length));
+    offset += length;
+  }
+  if (this->lawNames.size() != header[2] || this->mappedSize - offset != size_t(header[3]) * RECORD_SIZE)
+  {
+    this->close();
+    return false;
+  }
+
+  this->variables = header[1];
+  this->count = header[3];
+  this->records = this->mapped + offset;
+  return true;
+}
+
+void DistanceTable::close()
+{
+  if (this->mapped)
+  {
+#ifndef _WIN32
+    munmap(const_cast<char *>(this->mapped), this->mappedSize);
+#else
+    delete[] this->mapped;
+#endif
+  }
+  this->mapped = nullptr;
+  this->mappedSize = 0;
+  this->records = nullptr;
+  this->variables = 0;
+  this->count = 0;
+  this->lawNames.clear();
+}
+
+bool DistanceTable::find(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps) const
+{
+  uint64_t lhsKey;
+  uint64_t rhsKey;
+  uint32_t current;
+  uint32_t end;
+  if (!this->records || !encode(lhs, this->variables, lhsKey) || !encode(rhs, this->variables, rhsKey) ||
+      !this->lookup(lhsKey, current) || !this->lookup(rhsKey, end))
+    return false;
+
+  // walk from the lhs to its canonical expression
+  std::vector<std::vector<std::string>> proof = {{lhs->clone()->toStringTree(), "Given"}};
+  Record record = this->read(current);
+  while (record.toward != current)
+  {
+    if (record.toward >= this->count || record.towardLaw >= this->lawNames.size() || proof.size() > this->count)
+      return false;
+    proof.push_back({decode(this->read(record.toward).key)->toStringTree(), this->lawNames[record.towardLaw]});
+    current = record.toward;
+    record = this->read(current);
+  }
+
+  // walk back from the rhs to its canonical expression, then forward again
+  std::vector<std::pair<uint32_t, uint16_t>> back;
+  record = this->read(end);
+  while (record.from != end)
+  {
+    if (record.from >= this->count || record.fromLaw >= this->lawNames.size() || back.size() > this->count)
+      return false;
+    back.push_back({end, record.fromLaw});
+    end = record.from;
+    record = this->read(end);
+  }
+  if (end != current)
+    return false;
+  for (int i = back.size() - 1; i >= 0; i--)
+    proof.push_back({decode(this->read(back[i].first).key)->toStringTree(), this->lawNames[back[i].second]});
+
+  steps = proof;
+  return true;
+}
+
+int DistanceTable::size() const
+{
+  return this->count;
+}
+
+bool DistanceTable::encode(std::shared_ptr<Expression> expression, int variables, uint64_t &key)
+{
+  key = 0;
+  int nodes = 0;
+  std::vector<std::shared_ptr<Expression>> pending = {expression};
+  while (!pending.empty())
+  {
+    std::shared_ptr<Expression> current = pending.back();
+    pending.pop_back();
+    if (nodes == MAX_KEY_NODES)
+      return false;
+
+    uint64_t code;
+    if (current->isVar())
+    {
+      int variable = current->getValue()[0] - 'a';
+      if (variable < 0 || variable >= std::min(variables, MAX_KEY_VARIABLES))
+        return false;
+      code = SYMBOLS.size() + variable;
+    }
+    else
+    {
+      auto symbol = std::find(SYMBOLS.begin() + 1, SYMBOLS.end(), current->getValue());
+      if (symbol == SYMBOLS.end())
+        return false;
+      code = symbol - SYMBOLS.begin();
+    }
+    key |= code << (4 * nodes++);
+
+    if (current->hasRight())
+      pending.push_back(current->getRight());
+    if (current->hasLeft())
+      pending.push_back(current->getLeft());
+  }
+  return true;
+}
+
+std::shared_ptr<Expression> DistanceTable::decode(uint64_t key)
+{
+  return decodeKey(key);
+}
+
+DistanceTable::Record DistanceTable::read(uint32_t index) const
+{
+  Record record;
+  const char *position = this->records + size_t(index) * RECORD_SIZE;
+  std::memcpy(&record.key, position, sizeof(record.key));
+  position += sizeof(record.key);
+  std::memcpy(&record.toward, position, sizeof(record.toward));
+  position += sizeof(record.toward);
+  std::memcpy(&record.from, position, sizeof(record.from));
+  position += sizeof(record.from);
+  std::memcpy(&record.towardLaw, position, sizeof(record.towardLaw));
+  position += sizeof(record.towardLaw);
+  std::memcpy(&record.fromLaw, position, sizeof(record.fromLaw));
+  return record;
+}
+
+bool DistanceTable::lookup(uint64_t key, uint32_t &index) const
+{
+  uint32_t low = 0;
+  uint32_t high = this->count;
+  while (low < high)
+  {
+    uint32_t middle = low + (high - low) / 2;
+    uint64_t middleKey = this->read(middle).key;
+    if (middleKey == key)
+    {
+      index = middle;
+      return true;
+    }
+    if (middleKey < key)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return false;
+}
@@ -0,0 +1,344 @@
+/**
+ * @file eGraph.cpp
+ * @brief Implementation file for e-graph class
+ */
+
+#include "../include/eGraph.h"
+#include "../include/evaluator.h"
+#include "../include/solver.h"
+#include <algorithm>
+
+EGraph::EGraph()
+{
+  this->clear();
+}
+
+void EGraph::clear()
+{
+  this->nodes.clear();
+  this->parents.clear();
+  this->classes.clear();
+  this->hashcons.clear();
+  this->terms.clear();
+  this->proofParents.clear();
+  this->proofLaws.clear();
+  this->rules.clear();
+  this->ruleLaws.clear();
+  this->applied.clear();
+}
+
+void EGraph::addRule(EquivLaws::EquivLaw law)
+{
+  if (!this->ruleLaws.insert(law).second)
+    return;
+
+  auto lawPatterns = LawIndex::patterns.find(law);
+  if (lawPatterns == LawIndex::patterns.end())
+    return;
+
+  for (auto pattern : lawPatterns->second)
+  {
+    // the rhs can only be built from variables bound by the lhs
+    std::set<std::string> lhsVariables = pattern.lhs->getVariables();
+    std::set<std::string> rhsVariables = pattern.rhs->getVariables();
+    if (!std::includes(lhsVariables.begin(), lhsVariables.end(), rhsVariables.begin(), rhsVariables.end()))
+      continue;
+
+    if (isEquivalent(pattern.lhs, pattern.rhs))
+      this->rules.push_back({law, pattern.lhs, pattern.rhs});
+  }
+}
+
+void EGraph::addRules(const std::unordered_map<EquivLaws::EquivLaw, std::string> &laws)
+{
+  for (auto law : laws)
+    this->addRule(law.first);
+}
+
+int EGraph::add(std::shared_ptr<Expression> expression)
+{
+  Node node = {expression->getValue(), {}};
+  if (expression->hasLeft())
+    node.children.push_back(this->add(expression->getLeft()));
+  if (expression->hasRight())
+    node.children.push_back(this->add(expression->getRight()));
+  return this->addNode(node);
+}
+
+int EGraph::find(int node)
+{
+  int root = node;
+  while (this->parents[root] != root)
+    root = this->parents[root];
+
+  // point every node on the way directly at the root
+  while (this->parents[node] != root)
+  {
+    int next = this->parents[node];
+    this->parents[node] = root;
+    node = next;
+  }
+  return root;
+}
+
+bool EGraph::merge(int a, int b, EquivLaws::EquivLaw law)
+{
+  int rootA = this->find(a);
+  int rootB = this->find(b);
+  if (rootA == rootB)
+    return false;
+
+  // the new edge joins the proof trees of both nodes
+  this->makeProofRoot(a);
+  this->proofParents[a] = b;
+  this->proofLaws[a] = law;
+
+  // the smaller e-class joins the larger one
+  if (this->classes[rootA].size() > this->classes[rootB].size())
+    std::swap(rootA, rootB);
+  this->parents[rootA] = rootB;
+  std::vector<int> &merged = this->classes[rootB];
+  merged.insert(merged.end(), this->classes[rootA].begin(), this->classes[rootA].end());
+  this->classes.erase(rootA);
+  return true;
+}
+
+int EGraph::rebuild()
+{
+  int merges = 0;
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    this->hashcons.clear();
+    for (size_t id = 0; id < this->nodes.size(); id++)
+    {
+      Node key = this->canonicalize(this->nodes[id]);
+      auto existing = this->hashcons.find(key);
+      if (existing == this->hashcons.end())
+        this->hashcons[key] = id;
+      else if (this->merge(id, existing->second, nullptr))
+      {
+        merges++;
+        changed = true;
+      }
+    }
+  }
+  return merges;
+}
+
+int EGraph::step(int maxNodes)
+{
+  // match every rule before applying any, so the matches do not depend on
+  // the order the rules are applied in
+  std::vector<std::pair<int, Bindings>> found;
+  for (int id = 0; id < (int)this->nodes.size(); id++)
+  {
+    if (this->find(id) != id)
+      continue;
+
+    for (size_t rule = 0; rule < this->rules.size(); rule++)
+    {
+      Bindings unbound;
+      unbound.fill(-1);
+      std::vector<Bindings> matches;
+      this->match(this->rules[rule].lhs, id, unbound, matches);
+      for (auto bindings : matches)
+        found.push_back({rule, bindings});
+    }
+  }
+
+  int merges = 0;
+  for (auto match : found)
+  {
+    if ((int)this->nodes.size() >= maxNodes)
+      break;
+
+    for (int &eClass : match.second)
+    {
+      if (eClass != -1)
+        eClass = this->find(eClass);
+    }
+    if (!this->applied.insert(match).second)
+      continue;
+
+    const Rule &rule = this->rules[match.first];
+    int lhs = this->instantiate(rule.lhs, match.second);
+    int rhs = this->instantiate(rule.rhs, match.second);
+    if (this->merge(lhs, rhs, rule.law))
+      merges++;
+  }
+  return merges + this->rebuild();
+}
+
+int EGraph::size() const
+{
+  return this->nodes.size();
+}
+
+int EGraph::classCount() const
+{
+  return this->classes.size();
+}
+
+std::vector<std::vector<std::string>> EGraph::explain(int a, int b)
+{
+  if (this->find(a) != this->find(b))
+    return {};
+
+  std::shared_ptr<Expression> root = this->term(a);
+  std::vector<std::vector<std::string>> steps = {{root->toStringTree(), "Given"}};
+  this->explain(a, b, "", root, steps);
+  return steps;
+}
+
+int EGraph::addNode(const Node &node)
+{
+  auto term = this->terms.find(node);
+  if (term != this->terms.end())
+    return term->second;
+
+  int id = this->nodes.size();
+  this->nodes.push_back(node);
+  this->parents.push_back(id);
+  this->classes[id] = {id};
+  this->proofParents.push_back(-1);
+  this->proofLaws.push_back(nullptr);
+  this->terms[node] = id;
+
+  Node key = this->canonicalize(node);
+  auto existing = this->hashcons.find(key);
+  if (existing == this->hashcons.end())
+    this->hashcons[key] = id;
+  else
+    this->merge(id, existing->second, nullptr);
+  return id;
+}
+
+EGraph::Node EGraph::canonicalize(Node node)
+{
+  for (int &child : node.children)
+    child = this->find(child);
+  return node;
+}
+
+void EGraph::match(std::shared_ptr<Expression> pattern, int eClass, Bindings bindings, std::vector<Bindings> &matches)
+{
+  if (pattern->isVar())
+  {
+    int &bound = bindings[pattern->getValue()[0] - 'p'];
+    if (bound == -1)
+      bound = eClass;
+    if (bound == eClass)
+      matches.push_back(bindings);
+    return;
+  }
+
+  std::vector<std::shared_ptr<Expression>> children;
+  if (pattern->hasLeft())
+    children.push_back(pattern->getLeft());
+  if (pattern->hasRight())
+    children.push_back(pattern->getRight());
+
+  for (int id : this->classes[eClass])
+  {
+    const Node &node = this->nodes[id];
+    if (node.value != pattern->getValue() || node.children.size() != children.size())
+      continue;
+
+    // extend every partial match one child at a time
+    std::vector<Bindings> partial = {bindings};
+    for (size_t i = 0; i < children.size() && !partial.empty(); i++)
+    {
+      std::vector<Bindings> extended;
+      for (auto current : partial)
+        this->match(children[i], this->find(node.children[i]), current, extended);
+      partial = extended;
+    }
+    matches.insert(matches.end(), partial.begin(), partial.end());
+  }
+}
+
+int EGraph::instantiate(std::shared_ptr<Expression> pattern, const Bindings &bindings)
+{
+  if (pattern->isVar())
+    return bindings[pattern->getValue()[0] - 'p'];
+
+  Node node = {pattern->getValue(), {}};
+  if (pattern->hasLeft())
+    node.children.push_back(this->instantiate(pattern->getLeft(), bindings));
+  if (pattern->hasRight())
+    node.children.push_back(this->instantiate(pattern->getRight(), bindings));
+  return this->addNode(node);
+}
+
+void EGraph::makeProofRoot(int node)
+{
+  int previous = -1;
+  EquivLaws::EquivLaw previousLaw = nullptr;
+  while (node != -1)
+  {
+    int next = this->proofParents[node];
+    EquivLaws::EquivLaw nextLaw = this->proofLaws[node];
+    this->proofParents[node] = previous;
+    this->proofLaws[node] = previousLaw;
+    previous = node;
+    previousLaw = nextLaw;
+    node = next;
+  }
+}
+
+std::shared_ptr<Expression> EGraph::term(int node)
+{
+  std::shared_ptr<Expression> expression = std::make_shared<Expression>(this->nodes[node].value);
+  if (this->nodes[node].children.size() > 0)
+    expression->setLeft(this->term(this->nodes[node].children[0]), expression);
+  if (this->nodes[node].children.size() > 1)
+    expression->setRight(this->term(this->nodes[node].children[1]), expression);
+  return expression;
+}
+
+void EGraph::explain(int a, int b, const std::string &position, std::shared_ptr<Expression> &root, std::vector<std::vector<std::string>> &steps)
+{
+  if (a == b)
+    return;
+
+  // both nodes are in the same proof tree, meet at their closest common
+  // ancestor
+  std::set<int> ancestors;
+  for (int node = a; node != -1; node = this->proofParents[node])
+    ancestors.insert(node);
+  std::vector<int> down;
+  int common = b;
+  while (ancestors.find(common) == ancestors.end())
+  {
+    down.push_back(common);
+    common = this->proofParents[common];
+  }
+
+  // edges {from, to, law}, up from a and then down to b
+  std::vector<std::pair<std::pair<int, int>, EquivLaws::EquivLaw>> edges;
+  for (int node = a; node != common; node = this->proofParents[node])
+    edges.push_back({{node, this->proofParents[node]}, this->proofLaws[node]});
+  for (int i = down.size() - 1; i >= 0; i--)
+    edges.push_back({{this->proofParents[down[i]], down[i]}, this->proofLaws[down[i]]});
+
+  for (auto edge : edges)
+  {
+    int from = edge.first.first;
+    int to = edge.first.second;
+    if (edge.second == nullptr)
+    {
+      // congruent nodes only differ in their children
+      for (size_t i = 0; i < this->nodes[from].children.size(); i++)
+        this->explain(this->nodes[from].children[i], this->nodes[to].children[i], position + (i == 0 ? "L" : "R"), root, steps);
+      continue;
+    }
+
+    std::shared_ptr<Expression> subexpression = getSubexpression(root, position);
+    EquivLaws::replace(subexpression, this->term(to));
+    if (position.empty())
+      root = subexpression;
+    steps.push_back({root->toStringTree(), EquivLaws::getName(edge.second)});
+  }
+}
@@ -55,6 +55,121 @@ std::unordered_map<EquivLaws::EquivLaw, std::string>
         {bidirectionalImplication4Reversed, "Bidirectional Implication Equivalence"},
 };
 
+// bidirectionalImplication0Reversed and bidirectionalImplication3Reversed
+// accept more than the right hand side of their law, so applying the forward
+// law after them does not always give the original expression back
+std::unordered_map<EquivLaws::EquivLaw, EquivLaws::EquivLaw> EquivLaws::inverses = {
+    {commutative, commutative},
+    {associative, associativeReversed},
+    {associativeReversed, associative},
+    {distributive, distributiveReversed},
+    {distributiveReversed, distributive},
+    {deMorgan, deMorganReversed},
+    {deMorganReversed, deMorgan},
+    {implication0, implication0Reversed},
+    {implication0Reversed, implication0},
+    {implication1, implication1Reversed},
+    {implication1Reversed, implication1},
+    {implication2, implication2Reversed},
+    {implication2Reversed, implication2},
+    {implication3, implication3Reversed},
+    {implication3Reversed, implication3},
+    {implication4, implication4Reversed},
+    {implication4Reversed, implication4},
+    {implication5, implication5Reversed},
+    {implication5Reversed, implication5},
+    {implication6, implication6Reversed},
+    {implication6Reversed, implication6},
+    {implication7, implication7Reversed},
+    {implication7Reversed, implication7},
+    {implication8, implication8Reversed},
+    {implication8Reversed, implication8},
+    {bidirectionalImplication0, bidirectionalImplication0Reversed},
+    {bidirectionalImplication1, bidirectionalImplication1},
+    {bidirectionalImplication2, bidirectionalImplication2Reversed},
+    {bidirectionalImplication2Reversed, bidirectionalImplication2},
+    {bidirectionalImplication3, bidirectionalImplication3Reversed},
+    {bidirectionalImplication4, bidirectionalImplication4Reversed},
+    {bidirectionalImplication4Reversed, bidirectionalImplication4},
+};
+
+std::unordered_map<EquivLaws::EquivLaw, std::string> EquivLaws::macros = {};
+
+std::vector<std::vector<EquivLaws::MacroStep>> EquivLaws::macroSteps = {};
+
+const EquivLaws::EquivLaw EquivLaws::macroLaws[MAX_MACROS] = {
+    macro<0>, macro<1>, macro<2>, macro<3>, macro<4>, macro<5>, macro<6>, macro<7>,
+};
+
+EquivLaws::EquivLaw EquivLaws::addMacro(const std::vector<MacroStep> &steps)
+{
+  if (steps.size() < 2 || macroSteps.size() >= MAX_MACROS)
+    return nullptr;
+
+  std::string name;
+  for (auto step : steps)
+    name += (name.empty() ? "" : " + ") + getName(step.law);
+
+  EquivLaw law = macroLaws[macroSteps.size()];
+  macroSteps.push_back(steps);
+  macros[law] = name;
+  return law;
+}
+
+std::vector<EquivLaws::MacroStep> EquivLaws::getMacroSteps(EquivLaw law)
+{
+  for (size_t slot = 0; slot < macroSteps.size(); slot++)
+  {
+    if (macroLaws[slot] == law)
+      return macroSteps[slot];
+  }
+  return {};
+}
+
+void EquivLaws::clearMacros()
+{
+  macroSteps.clear();
+  macros.clear();
+}
+
+bool EquivLaws::applyMacro(int slot, std::shared_ptr<Expression> &expression)
+{
+  if (slot >= (int)macroSteps.size())
+    return false;
+
+  // apply the steps to a copy, so a step that does not apply leaves the
+  // expression as it was
+  std::shared_ptr<Expression> newExpression = expression->clone();
+  for (auto step : macroSteps[slot])
+  {
+    std::shared_ptr<Expression> subexpression = newExpression;
+    for (char direction : step.position)
+    {
+      subexpression = direction == 'L' ? subexpression->getLeft() : subexpression->getRight();
+      if (!subexpression)
+        return false;
+    }
+    if (!step.law(subexpression))
+      return false;
+    if (step.position.empty())
+      newExpression = subexpression;
+  }
+
+  replace(expression, newExpression);
+  return true;
+}
+
+std::string EquivLaws::getName(EquivLaw law)
+{
+  for (auto names : {&laws, &implications, &bidirectionalImplications, &macros})
+  {
+    auto name = names->find(law);
+    if (name != names->end())
+      return name->second;
+  }
+  return "";
+}
+
 void EquivLaws::replace(std::shared_ptr<Expression> &expression,
                         std::shared_ptr<Expression> newExpression)
 {
@@ -8,6 +8,8 @@
 Expression::Expression(std::string value)
 {
   this->value = value;
+  this->size = 1;
+  this->depth = 1;
 }
 
 std::string Expression::getValue()
@@ -36,6 +38,16 @@ bool Expression::isVar()
   return this->value.length() == 1 && std::islower(this->value[0]);
 }
 
+int Expression::getSize()
+{
+  return this->size;
+}
+
+int Expression::getDepth()
+{
+  return this->depth;
+}
+
 std::shared_ptr<Expression> Expression::getParent()
 {
   return this->parent;
@@ -55,12 +67,42 @@ void Expression::setLeft(std::shared_ptr<Expression> left, std::shared_ptr<Expre
 {
   this->left = left;
   this->left->setParent(parent);
+  this->updateMetrics();
 }
 
 void Expression::setRight(std::shared_ptr<Expression> right, std::shared_ptr<Expression> parent)
 {
   this->right = right;
   this->right->setParent(parent);
+  this->updateMetrics();
+}
+
+void Expression::updateMetrics()
+{
+  Expression *current = this;
+  while (current)
+  {
+    int newSize = 1;
+    int newDepth = 1;
+    if (current->hasLeft())
+    {
+      newSize += current->getLeft()->getSize();
+      newDepth = std::max(newDepth, current->getLeft()->getDepth() + 1);
+    }
+    if (current->hasRight())
+    {
+      newSize += current->getRight()->getSize();
+      newDepth = std::max(newDepth, current->getRight()->getDepth() + 1);
+    }
+
+    // the parents only change if this expression changed
+    if (current != this && newSize == current->size && newDepth == current->depth)
+      return;
+
+    current->size = newSize;
+    current->depth = newDepth;
+    current = current->getParent().get();
+  }
 }
 
 void Expression::setParent(std::shared_ptr<Expression> parent)
@@ -245,9 +287,11 @@ std::string Expression::toStringMinimal()
     if (!this->getRight()->isVar() && this->getRight()->getValue() != "T" &&
         this->getRight()->getValue() != "F")
     {
-      // determine operator precedence
+      // determine operator precedence, implications are grouped from the
+      // left and unlike the other operators cannot be regrouped
       if (precedence.at(this->getValue()) >
-          precedence.at(this->getRight()->getValue()))
+              precedence.at(this->getRight()->getValue()) ||
+          (this->getValue() == IMPLIES && this->getRight()->getValue() == IMPLIES))
       {
         rightMinimal = "(" + rightMinimal + ")";
       }
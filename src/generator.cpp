@@ -0,0 +1,112 @@
+/**
+ * @file generator.cpp
+ * @brief Implementation file for random problem functions
+ */
+
+#include "../include/generator.h"
+#include "../include/evaluator.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include <algorithm>
+#include <unordered_set>
+
+/**
+ * @brief Make a random expression of a given size whose leaves are left as ?
+ *
+ * @param random the random number generator
+ * @param nodes number of nodes of the expression
+ *
+ * @return string of the expression, fully parenthesized
+ */
+static std::string randomShape(std::mt19937 &random, int nodes)
+{
+  if (nodes == 1)
+    return "?";
+
+  // a negation is the only operator that fits two nodes
+  static const std::vector<std::string> binaryOperators = {AND, OR, IMPLIES, IFF};
+  if (nodes == 2 || std::uniform_int_distribution<int>(0, 4)(random) == 0)
+    return "!(" + randomShape(random, nodes - 1) + ")";
+
+  int leftNodes = std::uniform_int_distribution<int>(1, nodes - 2)(random);
+  std::string op = binaryOperators[std::uniform_int_distribution<int>(0, binaryOperators.size() - 1)(random)];
+  return "(" + randomShape(random, leftNodes) + ") " + op + " (" + randomShape(random, nodes - 1 - leftNodes) + ")";
+}
+
+std::shared_ptr<Expression> randomExpression(std::mt19937 &random, int variables, int nodes)
+{
+  std::string shape = randomShape(random, nodes);
+
+  // every variable once, then random ones for the remaining leaves
+  int leaves = std::count(shape.begin(), shape.end(), '?');
+  std::vector<char> names;
+  for (int i = 0; i < leaves; i++)
+    names.push_back('a' + (i < variables ? i : std::uniform_int_distribution<int>(0, variables - 1)(random)));
+  std::shuffle(names.begin(), names.end(), random);
+  for (char name : names)
+    shape[shape.find('?')] = name;
+
+  std::shared_ptr<Expression> expr;
+  parse(shape, expr);
+  return expr;
+}
+
+/**
+ * @brief Add the positions of every subexpression of an expression
+ *
+ * @param expr the expression
+ * @param position path from the root to the expression
+ * @param positions vector to add the positions to
+ */
+static void collectPositions(std::shared_ptr<Expression> expr, const std::string &position, std::vector<std::string> &positions)
+{
+  positions.push_back(position);
+  if (expr->hasLeft())
+    collectPositions(expr->getLeft(), position + "L", positions);
+  if (expr->hasRight())
+    collectPositions(expr->getRight(), position + "R", positions);
+}
+
+std::vector<std::vector<std::string>> randomRewrites(std::shared_ptr<Expression> expr, int rewrites, std::mt19937 &random)
+{
+  preprocess(expr, expr);
+
+  std::vector<std::vector<std::string>> steps = {{expr->toStringTree(), "Given"}};
+  std::unordered_set<std::string> seen = {steps[0][0]};
+  for (int i = 0; i < rewrites; i++)
+  {
+    // every law that leads somewhere new, of which one is taken
+    std::vector<std::pair<std::shared_ptr<Expression>, std::string>> candidates;
+    std::vector<std::string> positions;
+    collectPositions(expr, "", positions);
+    for (const std::string &position : positions)
+    {
+      std::shared_ptr<Expression> original = getSubexpression(expr, position)->clone();
+      for (EquivLaws::EquivLaw law : equivalenceIndex.match(getSubexpression(expr, position)))
+      {
+        std::shared_ptr<Expression> newExpr = expr->clone();
+        std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, position);
+        if (!law(subexpression))
+          continue;
+
+        // some laws do not hold for every subexpression they match, so the
+        // pairs are only equivalent if every rewrite is checked
+        if (!isEquivalent(original, subexpression->clone()))
+          continue;
+        if (position.empty())
+          newExpr = subexpression;
+        if (newExpr->getSize() > MAX_NODES || newExpr->getDepth() > MAX_DEPTH || seen.count(newExpr->toStringTree()))
+          continue;
+        candidates.push_back({newExpr, equivalences[law]});
+      }
+    }
+    if (candidates.empty())
+      break;
+
+    auto chosen = candidates[std::uniform_int_distribution<int>(0, candidates.size() - 1)(random)];
+    expr = chosen.first;
+    steps.push_back({expr->toStringTree(), chosen.second});
+    seen.insert(steps.back()[0]);
+  }
+  return steps;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file lawIndex.cpp
+ * @brief Implementation file for law index class
+ */
+
+#include "../include/lawIndex.h"
+#include <algorithm>
+
+const std::unordered_map<EquivLaws::EquivLaw, std::vector<rules::RulePattern>> LawIndex::patterns = []()
+{
+  std::unordered_map<EquivLaws::EquivLaw, std::vector<rules::RulePattern>> patterns;
+  rules::Laws::describe(patterns);
+  rules::Implications::describe(patterns);
+  rules::BidirectionalImplications::describe(patterns);
+  return patterns;
+}();
+
+LawIndex::LawIndex()
+{
+  this->clear();
+}
+
+void LawIndex::clear()
+{
+  this->nodes.clear();
+  this->nodes.push_back(Node());
+  this->unindexed.clear();
+  this->order.clear();
+}
+
+void LawIndex::insert(EquivLaws::EquivLaw law)
+{
+  if (this->order.find(law) != this->order.end())
+    return;
+
+  int lawOrder = this->order.size();
+  this->order[law] = lawOrder;
+
+  auto lawPatterns = patterns.find(law);
+  if (lawPatterns == patterns.end())
+  {
+    // no pattern is known, so the law has to be tried everywhere
+    this->unindexed.push_back({law, lawOrder, nullptr});
+    return;
+  }
+
+  for (auto pattern : lawPatterns->second)
+    this->insertPattern(pattern.lhs, {law, lawOrder, pattern.matches});
+}
+
+void LawIndex::insert(const std::unordered_map<EquivLaws::EquivLaw, std::string> &laws)
+{
+  for (auto law : laws)
+    this->insert(law.first);
+}
+
+void LawIndex::insertPattern(std::shared_ptr<Expression> pattern, Entry entry)
+{
+  // walk the pattern in preorder, every node is one symbol of the path
+  int node = 0;
+  std::vector<std::shared_ptr<Expression>> pending = {pattern};
+
+  while (!pending.empty())
+  {
+    std::shared_ptr<Expression> current = pending.back();
+    pending.pop_back();
+
+    std::string symbol = current->isVar() ? "*" : current->getValue();
+
+    auto child = this->nodes[node].children.find(symbol);
+    if (child == this->nodes[node].children.end())
+    {
+      this->nodes.push_back(Node());
+      int newNode = this->nodes.size() - 1;
+      this->nodes[node].children[symbol] = newNode;
+      node = newNode;
+    }
+    else
+      node = child->second;
+
+    if (current->isVar())
+      continue;
+    if (current->hasRight())
+      pending.push_back(current->getRight());
+    if (current->hasLeft())
+      pending.push_back(current->getLeft());
+  }
+
+  this->nodes[node].entries.push_back(entry);
+}
+
+std::vector<EquivLaws::EquivLaw> LawIndex::match(std::shared_ptr<Expression> expression) const
+{
+  std::vector<Entry> entries;
+  std::vector<std::shared_ptr<Expression>> pending = {expression};
+  this->retrieve(0, pending, entries);
+
+  // the discrimination tree ignores repeated variables, so check them now
+  entries.erase(std::remove_if(entries.begin(), entries.end(),
+                               [&](const Entry &entry)
+                               { return !entry.matches(expression); }),
+                entries.end());
+  entries.insert(entries.end(), this->unindexed.begin(), this->unindexed.end());
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b)
+            { return a.order < b.order; });
+
+  std::vector<EquivLaws::EquivLaw> laws;
+  for (auto entry : entries)
+  {
+    if (laws.empty() || laws.back() != entry.law)
+      laws.push_back(entry.law);
+  }
+  return laws;
+}
+
+bool LawIndex::measure(EquivLaws::EquivLaw law, std::shared_ptr<Expression> expression, int &size, int &depth)
+{
+  auto lawPatterns = patterns.find(law);
+  if (lawPatterns == patterns.end())
+    return false;
+
+  // laws apply their first matching rule
+  for (auto pattern : lawPatterns->second)
+  {
+    if (pattern.measure(expression, size, depth))
+      return true;
+  }
+  return false;
+}
+
+int LawIndex::size() const
+{
+  return this->order.size();
+}
+
+void LawIndex::retrieve(int node, std::vector<std::shared_ptr<Expression>> &pending, std::vector<Entry> &entries) const
+{
+  if (pending.empty())
+  {
+    entries.insert(entries.end(), this->nodes[node].entries.begin(), this->nodes[node].entries.end());
+    return;
+  }
+
+  std::shared_ptr<Expression> current = pending.back();
+  pending.pop_back();
+
+  // a pattern variable skips the whole subexpression
+  auto wildcard = this->nodes[node].children.find("*");
+  if (wildcard != this->nodes[node].children.end())
+    this->retrieve(wildcard->second, pending, entries);
+
+  auto child = this->nodes[node].children.find(current->getValue());
+  if (child != this->nodes[node].children.end())
+  {
+    int added = 0;
+    if (current->hasRight())
+    {
+      pending.push_back(current->getRight());
+      added++;
+    }
+    if (current->hasLeft())
+    {
+      pending.push_back(current->getLeft());
+      added++;
+    }
+
+    this->retrieve(child->second, pending, entries);
+
+    pending.resize(pending.size() - added);
+  }
+
+  pending.push_back(current);
+}
@@ -0,0 +1,483 @@
+/**
+ * @file normalForm.cpp
+ * @brief Implementation file for normal form functions
+ */
+
+#include "../include/normalForm.h"
+#include "../include/solver.h"
+#include <functional>
+
+/**
+ * @brief Expression being rewritten and the steps taken so far
+ */
+struct Rewrite {
+  /**
+   * @brief Pointer to the root of the current expression
+   */
+  std::shared_ptr<Expression> root;
+
+  /**
+   * @brief Steps from the original expression: {{expr, law},...}
+   */
+  std::vector<std::vector<std::string>> steps;
+};
+
+/**
+ * @brief Sort key of a literal or of a conjunction of literals
+ */
+typedef std::vector<std::pair<std::string, bool>> TermKey;
+
+/**
+ * @brief Add the current expression as a step of the rewrite
+ *
+ * @param rewrite reference to the rewrite
+ * @param law name of the law used for the step
+ */
+static void record(Rewrite &rewrite, const std::string &law)
+{
+  // laws share subexpressions between the parts they build, so the tree is
+  // copied to keep later steps from changing more than one place
+  rewrite.root = rewrite.root->clone();
+  rewrite.steps.push_back({rewrite.root->toStringTree(), law});
+}
+
+/**
+ * @brief Apply a law at a position of the current expression
+ *
+ * @param rewrite reference to the rewrite
+ * @param law the equivalence law to apply
+ * @param position path from the root to the subexpression
+ */
+static void apply(Rewrite &rewrite, EquivLaws::EquivLaw law, const std::string &position)
+{
+  std::shared_ptr<Expression> subexpression = getSubexpression(rewrite.root, position);
+  law(subexpression);
+  if (position.empty())
+    rewrite.root = subexpression;
+  record(rewrite, EquivLaws::getName(law));
+}
+
+/**
+ * @brief Replace a subexpression with an equivalent one, for laws used from
+ * right to left
+ *
+ * @param rewrite reference to the rewrite
+ * @param position path from the root to the subexpression
+ * @param expression pointer to the new subexpression
+ * @param law the equivalence law that turns the new subexpression back into
+ * the old one
+ */
+static void replace(Rewrite &rewrite, const std::string &position, std::shared_ptr<Expression> expression, EquivLaws::EquivLaw law)
+{
+  std::shared_ptr<Expression> subexpression = getSubexpression(rewrite.root, position);
+  EquivLaws::replace(subexpression, expression);
+  if (position.empty())
+    rewrite.root = subexpression;
+  record(rewrite, EquivLaws::getName(law));
+}
+
+/**
+ * @brief Build an expression from an operator and its subexpressions
+ *
+ * @param value the operator
+ * @param left pointer to the left subexpression
+ * @param right pointer to the right subexpression, nullptr for NOT
+ *
+ * @return pointer to the new expression
+ */
+static std::shared_ptr<Expression> build(std::string value, std::shared_ptr<Expression> left, std::shared_ptr<Expression> right = nullptr)
+{
+  std::shared_ptr<Expression> expression = std::make_shared<Expression>(value);
+  expression->setLeft(left, expression);
+  if (right)
+    expression->setRight(right, expression);
+  return expression;
+}
+
+/**
+ * @brief Build v | !v or v & !v for a variable
+ *
+ * @param value the operator
+ * @param variable the variable
+ *
+ * @return pointer to the new expression
+ */
+static std::shared_ptr<Expression> excludedMiddle(std::string value, const std::string &variable)
+{
+  return build(value, std::make_shared<Expression>(variable), build(NOT, std::make_shared<Expression>(variable)));
+}
+
+/**
+ * @brief Find the first subexpression in preorder that satisfies a predicate
+ *
+ * @param expr pointer to the current expression
+ * @param position path from the root to the current expression
+ * @param predicate the predicate
+ * @param found reference to the path of the subexpression found
+ *
+ * @return bool of whether a subexpression was found
+ */
+static bool findFirst(std::shared_ptr<Expression> expr, const std::string &position, const std::function<bool(std::shared_ptr<Expression>)> &predicate, std::string &found)
+{
+  if (predicate(expr))
+  {
+    found = position;
+    return true;
+  }
+  if (expr->hasLeft() && findFirst(expr->getLeft(), position + "L", predicate, found))
+    return true;
+  return expr->hasRight() && findFirst(expr->getRight(), position + "R", predicate, found);
+}
+
+/**
+ * @brief Get the sort key of a literal or a conjunction of literals nested
+ * to the right
+ *
+ * @param expr pointer to the expression
+ *
+ * @return the variables of the literals in order, true for negated ones
+ */
+static TermKey getTermKey(std::shared_ptr<Expression> expr)
+{
+  TermKey key;
+  while (expr->getValue() == AND)
+  {
+    TermKey literal = getTermKey(expr->getLeft());
+    key.insert(key.end(), literal.begin(), literal.end());
+    expr = expr->getRight();
+  }
+  if (expr->getValue() == NOT)
+    key.push_back({expr->getLeft()->getValue(), true});
+  else
+    key.push_back({expr->getValue(), false});
+  return key;
+}
+
+/**
+ * @brief Rewrite every bidirectional implication and implication into AND,
+ * OR and NOT
+ *
+ * @param rewrite reference to the rewrite
+ *
+ * @return bool of whether every operator could be rewritten
+ */
+static bool eliminateImplications(Rewrite &rewrite)
+{
+  std::string position;
+  auto isImplication = [](std::shared_ptr<Expression> expr)
+  { return expr->getValue() == IFF || expr->getValue() == IMPLIES || expr->getValue() == XOR; };
+
+  while (findFirst(rewrite.root, "", isImplication, position))
+  {
+    std::string value = getSubexpression(rewrite.root, position)->getValue();
+    if (value == XOR)
+      return false;
+    apply(rewrite, value == IFF ? EquivLaws::bidirectionalImplication3 : EquivLaws::implication0, position);
+  }
+  return true;
+}
+
+/**
+ * @brief Push every negation down to the variables
+ *
+ * @param rewrite reference to the rewrite
+ * @param variable variable used to negate T and F
+ */
+static void pushNegations(Rewrite &rewrite, const std::string &variable)
+{
+  std::string position;
+  auto isPushable = [](std::shared_ptr<Expression> expr)
+  { return expr->getValue() == NOT && !expr->getLeft()->isVar(); };
+
+  while (findFirst(rewrite.root, "", isPushable, position))
+  {
+    std::string value = getSubexpression(rewrite.root, position + "L")->getValue();
+    if (value == NOT)
+      apply(rewrite, EquivLaws::doubleNegation, position);
+    else if (value == AND || value == OR)
+      apply(rewrite, EquivLaws::deMorgan, position);
+    else
+    {
+      // no law negates a constant, so go through v | !v or v & !v instead
+      replace(rewrite, position + "L", excludedMiddle(value == TRUE ? OR : AND, variable), EquivLaws::negation);
+      apply(rewrite, EquivLaws::deMorgan, position);
+      apply(rewrite, EquivLaws::doubleNegation, position + "R");
+      apply(rewrite, EquivLaws::commutative, position);
+      apply(rewrite, EquivLaws::negation, position);
+    }
+  }
+}
+
+/**
+ * @brief Remove every T and F that is not the whole expression
+ *
+ * @param rewrite reference to the rewrite
+ */
+static void removeConstants(Rewrite &rewrite)
+{
+  std::string position;
+  auto isConstant = [](std::shared_ptr<Expression> expr)
+  { return expr->getValue() == TRUE || expr->getValue() == FALSE; };
+  auto hasConstant = [&](std::shared_ptr<Expression> expr)
+  { return expr->isBinary() && (isConstant(expr->getLeft()) || isConstant(expr->getRight())); };
+
+  while (findFirst(rewrite.root, "", hasConstant, position))
+  {
+    std::shared_ptr<Expression> expr = getSubexpression(rewrite.root, position);
+    if (!isConstant(expr->getRight()))
+    {
+      apply(rewrite, EquivLaws::commutative, position);
+      expr = getSubexpression(rewrite.root, position);
+    }
+
+    // p & T and p | F keep p, p & F and p | T keep the constant
+    bool keepsOther = (expr->getValue() == AND) == (expr->getRight()->getValue() == TRUE);
+    apply(rewrite, keepsOther ? EquivLaws::identity : EquivLaws::domination, position);
+  }
+}
+
+/**
+ * @brief Distribute every AND over OR
+ *
+ * @param rewrite reference to the rewrite
+ */
+static void distribute(Rewrite &rewrite)
+{
+  std::string position;
+  auto isDistributable = [](std::shared_ptr<Expression> expr)
+  { return expr->getValue() == AND && (expr->getLeft()->getValue() == OR || expr->getRight()->getValue() == OR); };
+
+  while (findFirst(rewrite.root, "", isDistributable, position))
+  {
+    if (getSubexpression(rewrite.root, position)->getRight()->getValue() != OR)
+      apply(rewrite, EquivLaws::commutative, position);
+    apply(rewrite, EquivLaws::distributive, position);
+  }
+}
+
+/**
+ * @brief Nest a chain of the same operator to the right
+ *
+ * @param rewrite reference to the rewrite
+ * @param position path from the root to the chain
+ * @param value the operator of the chain
+ *
+ * @return paths to the chain nodes, the last one is the last element
+ */
+static std::vector<std::string> nestRight(Rewrite &rewrite, const std::string &position, const std::string &value)
+{
+  std::vector<std::string> nodes;
+  std::string current = position;
+  while (getSubexpression(rewrite.root, current)->getValue() == value)
+  {
+    while (getSubexpression(rewrite.root, current)->getLeft()->getValue() == value)
+      apply(rewrite, EquivLaws::associative, current);
+    nodes.push_back(current);
+    current += "R";
+  }
+  nodes.push_back(current);
+  return nodes;
+}
+
+/**
+ * @brief Get the path to an element of a chain nested to the right
+ *
+ * @param nodes paths to the chain nodes
+ * @param i index of the element
+ *
+ * @return path to the element
+ */
+static std::string element(const std::vector<std::string> &nodes, int i)
+{
+  return i == (int)nodes.size() - 1 ? nodes[i] : nodes[i] + "L";
+}
+
+/**
+ * @brief Swap an element of a chain nested to the right with the next one
+ *
+ * @param rewrite reference to the rewrite
+ * @param node path to the chain node of the element
+ * @param value the operator of the chain
+ */
+static void swapNext(Rewrite &rewrite, const std::string &node, const std::string &value)
+{
+  if (getSubexpression(rewrite.root, node)->getRight()->getValue() != value)
+  {
+    apply(rewrite, EquivLaws::commutative, node);
+    return;
+  }
+  apply(rewrite, EquivLaws::associativeReversed, node);
+  apply(rewrite, EquivLaws::commutative, node + "L");
+  apply(rewrite, EquivLaws::associative, node);
+}
+
+/**
+ * @brief Sort a chain nested to the right by the keys of its elements
+ *
+ * @param rewrite reference to the rewrite
+ * @param nodes paths to the chain nodes
+ * @param value the operator of the chain
+ */
+static void sortChain(Rewrite &rewrite, const std::vector<std::string> &nodes, const std::string &value)
+{
+  for (size_t pass = 0; pass + 1 < nodes.size(); pass++)
+  {
+    for (size_t i = 0; i + 1 < nodes.size() - pass; i++)
+    {
+      if (getTermKey(getSubexpression(rewrite.root, element(nodes, i + 1))) <
+          getTermKey(getSubexpression(rewrite.root, element(nodes, i))))
+        swapNext(rewrite, nodes[i], value);
+    }
+  }
+}
+
+/**
+ * @brief Merge an element of a chain nested to the right into the next one,
+ * using a law that applies to the two elements
+ *
+ * @param rewrite reference to the rewrite
+ * @param node path to the chain node of the element
+ * @param value the operator of the chain
+ * @param law the law that merges the two elements
+ */
+static void mergeNext(Rewrite &rewrite, const std::string &node, const std::string &value, EquivLaws::EquivLaw law)
+{
+  if (getSubexpression(rewrite.root, node)->getRight()->getValue() != value)
+  {
+    apply(rewrite, law, node);
+    return;
+  }
+  apply(rewrite, EquivLaws::associativeReversed, node);
+  apply(rewrite, law, node + "L");
+}
+
+/**
+ * @brief Sort the literals of a conjunction and remove repeated ones
+ *
+ * @param rewrite reference to the rewrite
+ * @param position path from the root to the conjunction
+ *
+ * @return bool of whether the conjunction is satisfiable, otherwise it was
+ * rewritten to F
+ */
+static bool normalizeTerm(Rewrite &rewrite, const std::string &position)
+{
+  std::vector<std::string> nodes = nestRight(rewrite, position, AND);
+  sortChain(rewrite, nodes, AND);
+
+  for (size_t i = 0; i + 1 < nodes.size();)
+  {
+    TermKey current = getTermKey(getSubexpression(rewrite.root, element(nodes, i)));
+    TermKey next = getTermKey(getSubexpression(rewrite.root, element(nodes, i + 1)));
+    if (current[0].first != next[0].first)
+    {
+      i++;
+      continue;
+    }
+
+    if (current == next)
+    {
+      mergeNext(rewrite, nodes[i], AND, EquivLaws::idempotent);
+      nodes.pop_back();
+      continue;
+    }
+
+    // p & !p, the whole conjunction is F
+    mergeNext(rewrite, nodes[i], AND, EquivLaws::negation);
+    if (getSubexpression(rewrite.root, nodes[i])->getValue() == AND)
+    {
+      apply(rewrite, EquivLaws::commutative, nodes[i]);
+      apply(rewrite, EquivLaws::domination, nodes[i]);
+    }
+    for (int j = i - 1; j >= 0; j--)
+      apply(rewrite, EquivLaws::domination, nodes[j]);
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::vector<std::string>> normalize(std::shared_ptr<Expression> expr, std::set<std::string> variables)
+{
+  std::set<std::string> exprVariables = expr->getVariables();
+  variables.insert(exprVariables.begin(), exprVariables.end());
+  if ((int)variables.size() > MAX_NORMAL_FORM_VARIABLES)
+    return {};
+  if (variables.empty())
+    variables.insert("p");
+
+  Rewrite rewrite = {expr->clone(), {}};
+  rewrite.steps.push_back({rewrite.root->toStringTree(), "Given"});
+
+  if (!eliminateImplications(rewrite))
+    return {};
+  pushNegations(rewrite, *variables.begin());
+  removeConstants(rewrite);
+  distribute(rewrite);
+
+  // a contradiction is F already, a tautology starts from v | !v
+  if (rewrite.root->getValue() == FALSE)
+    return rewrite.steps;
+  if (rewrite.root->getValue() == TRUE)
+    replace(rewrite, "", excludedMiddle(OR, *variables.begin()), EquivLaws::negation);
+
+  while (true)
+  {
+    // normalize the conjunctions from the last one, so the paths of the
+    // earlier ones stay the same when one is removed
+    std::vector<std::string> nodes = nestRight(rewrite, "", OR);
+    for (int i = nodes.size() - 1; i >= 0; i--)
+    {
+      if (normalizeTerm(rewrite, element(nodes, i)))
+        continue;
+      if (nodes.size() == 1)
+        return rewrite.steps;
+
+      // drop the F from the disjunction
+      if (i == (int)nodes.size() - 1)
+        apply(rewrite, EquivLaws::identity, nodes[i - 1]);
+      else
+      {
+        apply(rewrite, EquivLaws::commutative, nodes[i]);
+        apply(rewrite, EquivLaws::identity, nodes[i]);
+      }
+      nodes.pop_back();
+    }
+
+    // split the first conjunction that misses a variable v into
+    // (... & v) | (... & !v)
+    bool expanded = false;
+    for (size_t i = 0; i < nodes.size() && !expanded; i++)
+    {
+      std::string position = element(nodes, i);
+      std::set<std::string> missing = variables;
+      for (auto literal : getTermKey(getSubexpression(rewrite.root, position)))
+        missing.erase(literal.first);
+      if (missing.empty())
+        continue;
+
+      replace(rewrite, position, build(AND, getSubexpression(rewrite.root, position)->clone(), std::make_shared<Expression>(TRUE)), EquivLaws::identity);
+      replace(rewrite, position + "R", excludedMiddle(OR, *missing.begin()), EquivLaws::negation);
+      apply(rewrite, EquivLaws::distributive, position);
+      expanded = true;
+    }
+    if (!expanded)
+      break;
+  }
+
+  // every conjunction has one literal per variable, sort them and merge the
+  // repeated ones
+  std::vector<std::string> nodes = nestRight(rewrite, "", OR);
+  sortChain(rewrite, nodes, OR);
+  for (size_t i = 0; i + 1 < nodes.size();)
+  {
+    if (getTermKey(getSubexpression(rewrite.root, element(nodes, i))) ==
+        getTermKey(getSubexpression(rewrite.root, element(nodes, i + 1))))
+    {
+      mergeNext(rewrite, nodes[i], OR, EquivLaws::idempotent);
+      nodes.pop_back();
+    }
+    else
+      i++;
+  }
+  return rewrite.steps;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file proofCache.cpp
+ * @brief Implementation file for proof cache class
+ */
+
+#include "../include/proofCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief First bytes of every proof cache file
+ */
+static const std::string MAGIC = "LOGIXPR-PROOFS-1\n";
+
+/**
+ * @brief Append a string with its length to a record
+ *
+ * @param record reference to the record
+ * @param str the string
+ */
+static void appendString(std::string &record, const std::string &str)
+{
+  uint32_t length = str.size();
+  record.append(reinterpret_cast<const char *>(&length), sizeof(length));
+  record.append(str);
+}
+
+ProofCache::ProofCache() : mapped(nullptr), mappedSize(0)
+{
+}
+
+ProofCache::~ProofCache()
+{
+  this->close();
+}
+
+bool ProofCache::open(const std::string &path)
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->reset();
+
+  // a new cache only holds the magic string
+  if (!std::filesystem::exists(path))
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << MAGIC;
+    if (!file.good())
+      return false;
+  }
+
+#ifndef _WIN32
+  int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0)
+    return false;
+  struct stat status;
+  if (fstat(descriptor, &status) != 0)
+  {
+    ::close(descriptor);
+    return false;
+  }
+  this->mappedSize = status.st_size;
+  void *memory = this->mappedSize > 0 ? mmap(nullptr, this->mappedSize, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+  ::close(descriptor);
+  if (memory == MAP_FAILED)
+  {
+    this->mappedSize = 0;
+    return false;
+  }
+  this->mapped = static_cast<const char *>(memory);
+#else
+  // without mmap, read the whole file into memory instead
+  std::ifstream file(path, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  this->mappedSize = contents.size();
+  char *memory = new char[this->mappedSize];
+  std::memcpy(memory, contents.data(), this->mappedSize);
+  this->mapped = memory;
+#endif
+
+  if (this->mappedSize < MAGIC.size() || std::memcmp(this->mapped, MAGIC.data(), MAGIC.size()) != 0)
+  {
+    this->reset();
+    return false;
+  }
+
+  // index every complete record, and cut off a record left half written
+  size_t offset = MAGIC.size();
+  std::vector<std::string> strings;
+  while (this->decode(offset, strings))
+  {
+    Key key;
+    std::memcpy(&key.first, this->mapped + offset + sizeof(uint32_t), sizeof(uint64_t));
+    std::memcpy(&key.second, this->mapped + offset + sizeof(uint32_t) + sizeof(uint64_t), sizeof(uint64_t));
+    this->offsets[key].push_back(offset);
+
+    uint32_t length;
+    std::memcpy(&length, this->mapped + offset, sizeof(length));
+    offset += sizeof(length) + length;
+  }
+  if (offset < this->mappedSize)
+  {
+    std::error_code error;
+    std::filesystem::resize_file(path, offset, error);
+    if (error)
+    {
+      this->reset();
+      return false;
+    }
+  }
+
+  this->path = path;
+  return true;
+}
+
+void ProofCache::close()
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->reset();
+}
+
+void ProofCache::reset()
+{
+  if (this->mapped)
+  {
+#ifndef _WIN32
+    munmap(const_cast<char *>(this->mapped), this->mappedSize);
+#else
+    delete[] this->mapped;
+#endif
+  }
+  this->mapped = nullptr;
+  this->mappedSize = 0;
+  this->path.clear();
+  this->offsets.clear();
+  this->appended.clear();
+}
+
+bool ProofCache::find(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps)
+{
+  std::string lhsString = lhs->toStringTree();
+  std::string rhsString = rhs->toStringTree();
+  Key key = {fingerprint(lhs), fingerprint(rhs)};
+
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->findUnlocked(key, lhsString, rhsString, steps);
+}
+
+bool ProofCache::insert(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, const std::vector<std::vector<std::string>> &steps)
+{
+  std::string lhsString = lhs->toStringTree();
+  std::string rhsString = rhs->toStringTree();
+  Key key = {fingerprint(lhs), fingerprint(rhs)};
+
+  std::lock_guard<std::mutex> guard(this->lock);
+  std::vector<std::vector<std::string>> cached;
+  if (this->path.empty() || this->findUnlocked(key, lhsString, rhsString, cached))
+    return false;
+
+  std::string body;
+  body.append(reinterpret_cast<const char *>(&key.first), sizeof(key.first));
+  body.append(reinterpret_cast<const char *>(&key.second), sizeof(key.second));
+  appendString(body, lhsString);
+  appendString(body, rhsString);
+  for (auto step : steps)
+  {
+    appendString(body, step[0]);
+    appendString(body, step[1]);
+  }
+
+  // the record is written in one go, so a crash can only cut off its end
+  std::string record;
+  appendString(record, body);
+  std::ofstream file(this->path, std::ios::binary | std::ios::app);
+  file.write(record.data(), record.size());
+  file.flush();
+  if (!file.good())
+    return false;
+
+  std::vector<std::vector<std::string>> proof = {{lhsString, rhsString}};
+  proof.insert(proof.end(), steps.begin(), steps.end());
+  this->appended[key] = proof;
+  return true;
+}
+
+std::vector<std::vector<std::vector<std::string>>> ProofCache::proofs()
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  std::vector<std::vector<std::vector<std::string>>> all;
+  std::vector<std::string> strings;
+  for (auto &records : this->offsets)
+  {
+    for (size_t offset : records.second)
+    {
+      if (!this->decode(offset, strings))
+        continue;
+      std::vector<std::vector<std::string>> steps;
+      for (size_t i = 2; i < strings.size(); i += 2)
+        steps.push_back({strings[i], strings[i + 1]});
+      all.push_back(steps);
+    }
+  }
+  for (auto &proof : this->appended)
+    all.push_back(std::vector<std::vector<std::string>>(proof.second.begin() + 1, proof.second.end()));
+  return all;
+}
+
+int ProofCache::size()
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  int count = this->appended.size();
+  for (auto &records : this->offsets)
+    count += records.second.size();
+  return count;
+}
+
+uint64_t ProofCache::fingerprint(std::shared_ptr<Expression> expression)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : expression->toStringTree())
+  {
+    hash ^= c;
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool ProofCache::decode(size_t offset, std::vector<std::string> &strings) const
+{
+  strings.clear();
+  uint32_t length;
+  if (offset + sizeof(length) > this->mappedSize)
+    return false;
+  std::memcpy(&length, this->mapped + offset, sizeof(length));
+  size_t end = offset + sizeof(length) + length;
+  if (end > this->mappedSize || length < 2 * sizeof(uint64_t))
+    return false;
+
+  size_t position = offset + sizeof(length) + 2 * sizeof(uint64_t);
+  while (position < end)
+  {
+    uint32_t stringLength;
+    if (position + sizeof(stringLength) > end)
+      return false;
+    std::memcpy(&stringLength, this->mapped + position, sizeof(stringLength));
+    position += sizeof(stringLength);
+    if (position + stringLength > end)
+      return false;
+    strings.push_back(std::string(this->mapped + position, stringLength));
+    position += stringLength;
+  }
+
+  // the lhs, the rhs and two strings per step
+  return strings.size() >= 2 && strings.size() % 2 == 0;
+}
+
+bool ProofCache::findUnlocked(const Key &key, const std::string &lhsString, const std::string &rhsString, std::vector<std::vector<std::string>> &steps) const
+{
+  // different expressions can share fingerprints, so compare the strings too
+  auto added = this->appended.find(key);
+  if (added != this->appended.end() && added->second[0][0] == lhsString && added->second[0][1] == rhsString)
+  {
+    steps.assign(added->second.begin() + 1, added->second.end());
+    return true;
+  }
+
+  auto records = this->offsets.find(key);
+  if (records == this->offsets.end())
+    return false;
+
+  std::vector<std::string> strings;
+  for (size_t offset : records->second)
+  {
+    if (!this->decode(offset, strings) || strings[0] != lhsString || strings[1] != rhsString)
+      continue;
+    steps.clear();
+    for (size_t i = 2; i < strings.size(); i += 2)
+      steps.push_back({strings[i], strings[i + 1]});
+    return true;
+  }
+  return false;
+}
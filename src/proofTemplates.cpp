@@ -0,0 +1,193 @@
+/**
+ * @file proofTemplates.cpp
+ * @brief Implementation file for proof templates class
+ */
+
+#include "../include/proofTemplates.h"
+#include "../include/parser.h"
+#include <algorithm>
+#include <set>
+
+ProofTemplates::ProofTemplates()
+{
+  this->clear();
+}
+
+void ProofTemplates::clear()
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->templates.clear();
+  this->added.clear();
+  this->nodes.clear();
+  this->nodes.push_back(Node());
+}
+
+bool ProofTemplates::insert(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, const std::vector<std::vector<std::string>> &steps)
+{
+  if (steps.size() < 2)
+    return false;
+
+  Template proof = {lhs->clone(), rhs->clone(), {}, {}};
+  std::set<std::string> variables = lhs->getVariables();
+  std::set<std::string> rhsVariables = rhs->getVariables();
+  variables.insert(rhsVariables.begin(), rhsVariables.end());
+
+  // a variable that only appears in between would not be bound by a match
+  for (size_t i = 1; i < steps.size(); i++)
+  {
+    std::shared_ptr<Expression> expr;
+    if (!parse(steps[i][0], expr))
+      return false;
+    std::set<std::string> stepVariables = expr->getVariables();
+    if (!std::includes(variables.begin(), variables.end(), stepVariables.begin(), stepVariables.end()))
+      return false;
+    proof.expressions.push_back(expr);
+    proof.laws.push_back(steps[i][1]);
+  }
+
+  std::lock_guard<std::mutex> guard(this->lock);
+  std::string key = proof.lhs->toStringTree() + " = " + proof.rhs->toStringTree();
+  if (this->added.find(key) != this->added.end())
+    return false;
+  this->added[key] = this->templates.size();
+
+  // walk the lhs in preorder, every node is one symbol of the path
+  int node = 0;
+  std::vector<std::shared_ptr<Expression>> pending = {proof.lhs};
+  while (!pending.empty())
+  {
+    std::shared_ptr<Expression> current = pending.back();
+    pending.pop_back();
+
+    std::string symbol = current->isVar() ? "*" : current->getValue();
+    auto child = this->nodes[node].children.find(symbol);
+    if (child == this->nodes[node].children.end())
+    {
+      this->nodes.push_back(Node());
+      int newNode = this->nodes.size() - 1;
+      this->nodes[node].children[symbol] = newNode;
+      node = newNode;
+    }
+    else
+      node = child->second;
+
+    if (current->hasRight())
+      pending.push_back(current->getRight());
+    if (current->hasLeft())
+      pending.push_back(current->getLeft());
+  }
+
+  this->nodes[node].templates.push_back(this->templates.size());
+  this->templates.push_back(proof);
+  return true;
+}
+
+bool ProofTemplates::instantiate(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::vector<std::vector<std::string>> &steps)
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  std::vector<int> found;
+  std::vector<std::shared_ptr<Expression>> pending = {lhs};
+  this->retrieve(0, pending, found);
+
+  // the discrimination tree ignores repeated variables and the rhs, so check
+  // every candidate with a full match
+  int best = -1;
+  Substitution bestSubstitution;
+  for (int index : found)
+  {
+    Substitution substitution;
+    if (!match(this->templates[index].lhs, lhs, substitution) || !match(this->templates[index].rhs, rhs, substitution))
+      continue;
+    if (best == -1 || this->templates[index].laws.size() < this->templates[best].laws.size())
+    {
+      best = index;
+      bestSubstitution = substitution;
+    }
+  }
+  if (best == -1)
+    return false;
+
+  const Template &proof = this->templates[best];
+  steps = {{lhs->clone()->toStringTree(), "Given"}};
+  for (size_t i = 0; i < proof.expressions.size(); i++)
+    steps.push_back({substitute(proof.expressions[i], bestSubstitution)->toStringTree(), proof.laws[i]});
+  return true;
+}
+
+int ProofTemplates::size()
+{
+  std::lock_guard<std::mutex> guard(this->lock);
+  return this->templates.size();
+}
+
+void ProofTemplates::retrieve(int node, std::vector<std::shared_ptr<Expression>> &pending, std::vector<int> &found) const
+{
+  if (pending.empty())
+  {
+    found.insert(found.end(), this->nodes[node].templates.begin(), this->nodes[node].templates.end());
+    return;
+  }
+
+  std::shared_ptr<Expression> current = pending.back();
+  pending.pop_back();
+
+  // a variable of a template skips the whole subexpression
+  auto wildcard = this->nodes[node].children.find("*");
+  if (wildcard != this->nodes[node].children.end())
+    this->retrieve(wildcard->second, pending, found);
+
+  auto child = this->nodes[node].children.find(current->getValue());
+  if (child != this->nodes[node].children.end() && !current->isVar())
+  {
+    int added = 0;
+    if (current->hasRight())
+    {
+      pending.push_back(current->getRight());
+      added++;
+    }
+    if (current->hasLeft())
+    {
+      pending.push_back(current->getLeft());
+      added++;
+    }
+
+    this->retrieve(child->second, pending, found);
+
+    pending.resize(pending.size() - added);
+  }
+
+  pending.push_back(current);
+}
+
+bool ProofTemplates::match(std::shared_ptr<Expression> pattern, std::shared_ptr<Expression> expression, Substitution &substitution)
+{
+  if (pattern->isVar())
+  {
+    auto bound = substitution.find(pattern->getValue());
+    if (bound == substitution.end())
+    {
+      substitution[pattern->getValue()] = expression;
+      return true;
+    }
+    return bound->second == expression || bound->second->compare(expression);
+  }
+
+  if (pattern->getValue() != expression->getValue() || pattern->hasLeft() != expression->hasLeft() || pattern->hasRight() != expression->hasRight())
+    return false;
+  if (pattern->hasLeft() && !match(pattern->getLeft(), expression->getLeft(), substitution))
+    return false;
+  return !pattern->hasRight() || match(pattern->getRight(), expression->getRight(), substitution);
+}
+
+std::shared_ptr<Expression> ProofTemplates::substitute(std::shared_ptr<Expression> pattern, const Substitution &substitution)
+{
+  if (pattern->isVar())
+    return substitution.at(pattern->getValue())->clone();
+
+  std::shared_ptr<Expression> expression = std::make_shared<Expression>(pattern->getValue());
+  if (pattern->hasLeft())
+    expression->setLeft(substitute(pattern->getLeft(), substitution), expression);
+  if (pattern->hasRight())
+    expression->setRight(substitute(pattern->getRight(), substitution), expression);
+  return expression;
+}
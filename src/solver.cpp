@@ -4,14 +4,45 @@
  */
 
 #include "../include/solver.h"
+#include "../include/eGraph.h"
+#include "../include/evaluator.h"
+#include "../include/normalForm.h"
+#include "../include/parser.h"
+#include "../include/tracer.h"
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <thread>
 
 std::unordered_map<EquivLaws::EquivLaw, std::string> equivalences = {};
+LawIndex equivalenceIndex;
+ProofTemplates proofTemplates;
+DistanceTable distanceTable;
 
-int MAX_QUEUE_SIZE = 2500;
-int MAX_EXPRESSION_LENGTH = 50;
+int MAX_MEMORY_MB = 256;
+int MAX_PROOF_LENGTH = 12;
+int TRANSPOSITION_TABLE_SIZE = 4096;
+int BEAM_WIDTH = 64;
+int DEFAULT_LAW_COST = 10;
+std::unordered_map<std::string, int> LAW_COSTS = {};
+int MAX_EGRAPH_NODES = 20000;
+int SHORTEN_WINDOW = 4;
+bool FREEZE_ALIGNED = false;
+bool USE_TEMPLATES = false;
+SearchMode SEARCH_MODE = SearchMode::BreadthFirst;
+int MAX_NODES = 15;
+int MAX_DEPTH = 7;
+int MAX_DECOMPOSITION_THREADS = std::thread::hardware_concurrency();
+
+/**
+ * @brief Number of threads decomposedSearch is running at the moment
+ */
+static std::atomic<int> decompositionThreads(0);
 
 void preprocess(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
 {
+  TraceSpan span("Preprocess");
+
   // include laws
   equivalences.clear();
   equivalences.insert(EquivLaws::laws.begin(), EquivLaws::laws.end());
@@ -29,88 +60,1518 @@ void preprocess(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs
   {
     equivalences.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
   }
+
+  // macros only made of the laws above
+  for (auto macro : EquivLaws::macros)
+  {
+    std::vector<EquivLaws::MacroStep> steps = EquivLaws::getMacroSteps(macro.first);
+    auto isIncluded = [](const EquivLaws::MacroStep &step)
+    { return equivalences.find(step.law) != equivalences.end(); };
+    if (std::all_of(steps.begin(), steps.end(), isIncluded))
+      equivalences.insert(macro);
+  }
+
+  equivalenceIndex.clear();
+  equivalenceIndex.insert(equivalences);
+}
+
+/**
+ * @brief Get the bytes a string allocates outside of itself
+ *
+ * @param str the string
+ *
+ * @return number of bytes, 0 for short strings stored inside the string
+ */
+static size_t stringMemory(const std::string &str)
+{
+  static const size_t inlineCapacity = std::string().capacity();
+  return str.capacity() > inlineCapacity ? str.capacity() + 1 : 0;
+}
+
+/**
+ * @brief Follow the map of visited expressions back from an expression to the
+ * lhs
+ *
+ * @param visited map of visited expressions to the expression they were
+ * derived from and the law used
+ * @param exprString string of the last expression of the proof
+ *
+ * @return vector of vector of strings of the steps: {{lhs, law},...}
+ */
+static std::vector<std::vector<std::string>> backtrack(std::unordered_map<std::string, std::pair<std::string, std::string>> &visited, std::string exprString)
+{
+  std::vector<std::vector<std::string>> steps;
+  while (exprString != "")
+  {
+    steps.push_back({exprString, visited[exprString].second});
+    exprString = visited[exprString].first;
+  }
+  std::reverse(steps.begin(), steps.end());
+  return steps;
+}
+
+/**
+ * @brief Combine the result of a search with the result of the search that
+ * took over from it
+ *
+ * @param failed result of the search that gave up
+ * @param fallback result of the search that took over
+ *
+ * @return the fallback result with the statistics of both searches
+ */
+static ProofResult fallBack(const ProofResult &failed, ProofResult fallback)
+{
+  addStats(fallback.stats, failed.stats);
+  return fallback;
+}
+
+/**
+ * @brief Cut out the steps between two visits of the same expression
+ *
+ * @param steps steps of the proof: {{lhs, law},...}
+ *
+ * @return the steps without loops
+ */
+static std::vector<std::vector<std::string>> removeLoops(const std::vector<std::vector<std::string>> &steps)
+{
+  std::vector<std::vector<std::string>> result;
+  std::unordered_map<std::string, int> seen;
+  for (auto step : steps)
+  {
+    auto previous = seen.find(step[0]);
+    if (previous != seen.end())
+    {
+      for (int i = previous->second + 1; i < (int)result.size(); i++)
+        seen.erase(result[i][0]);
+      result.resize(previous->second + 1);
+      continue;
+    }
+    seen[step[0]] = result.size();
+    result.push_back(step);
+  }
+  return result;
 }
 
 std::vector<std::vector<std::string>> proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
 {
+  SearchStats stats;
+  return proveEquivalence(lhs, rhs, stats);
+}
+
+std::vector<std::vector<std::string>> proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, SearchStats &stats)
+{
+  std::atomic<bool> cancelled(false);
+  ProofResult result = proveEquivalence(lhs, rhs, std::chrono::steady_clock::time_point::max(), cancelled);
+  stats = result.stats;
+
+  if (result.status == ProofStatus::Proved)
+    return result.steps;
+  if (result.status == ProofStatus::OutOfMemory)
+    return {{"", "Too many steps :("}};
+  return {{"", "Couldn't find a solution :("}};
+}
+
+/**
+ * @brief Prove the expressions are equivalent with the strategy of
+ * SEARCH_MODE and its fallbacks
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+static ProofResult searchWhole(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  if (SEARCH_MODE == SearchMode::IterativeDeepening)
+    return iterativeDeepeningSearch(lhs, rhs, deadline, cancelled);
+  if (SEARCH_MODE == SearchMode::Beam)
+    return shortenProof(beamSearch(lhs, rhs, deadline, cancelled), SHORTEN_WINDOW, deadline, cancelled);
+  // the cheapest proof may take more steps on purpose
+  if (SEARCH_MODE == SearchMode::UniformCost)
+    return uniformCostSearch(lhs, rhs, deadline, cancelled);
+
+  if (SEARCH_MODE == SearchMode::NormalForm)
+    return shortenProof(normalFormSearch(lhs, rhs, deadline, cancelled), SHORTEN_WINDOW, deadline, cancelled);
+  if (SEARCH_MODE == SearchMode::EGraph)
+    return shortenProof(eGraphSearch(lhs, rhs, deadline, cancelled), SHORTEN_WINDOW, deadline, cancelled);
+
+  ProofResult result = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+
+  // fall back to a search that only keeps the current path in memory
+  if (result.status == ProofStatus::OutOfMemory)
+    result = fallBack(result, iterativeDeepeningSearch(lhs, rhs, deadline, cancelled));
+
+  // the proof is too long or too wide to search for, bridge through the
+  // normal form instead
+  if (result.status == ProofStatus::NotFound || result.status == ProofStatus::OutOfMemory)
+    result = shortenProof(fallBack(result, normalFormSearch(lhs, rhs, deadline, cancelled)), SHORTEN_WINDOW, deadline, cancelled);
+  return result;
+}
+
+ProofResult proveEquivalence(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Prove");
   if (lhs->compare(rhs))
-    return {{"", "Given"}};
+    return {ProofStatus::Proved, {{"", "Given"}}, {}};
 
-  std::vector<std::vector<std::string>> steps;
+  // search the problem with its variables in a fixed order
+  std::unordered_map<std::string, std::string> renaming = getRenaming(lhs, rhs);
+  auto isRenamed = [](const std::pair<const std::string, std::string> &name)
+  { return name.first != name.second; };
+  if (std::any_of(renaming.begin(), renaming.end(), isRenamed))
+  {
+    ProofResult result = proveEquivalence(renameVariables(lhs, renaming), renameVariables(rhs, renaming), deadline, cancelled);
+    result.steps = renameSteps(result.steps, invertRenaming(renaming));
+    return result;
+  }
+
+  // small problems are a walk through the precomputed table
+  ProofResult result;
+  if (distanceTable.find(lhs, rhs, result.steps))
+  {
+    result.status = ProofStatus::Proved;
+    result.steps = removeLoops(result.steps);
+    return result;
+  }
+
+  // a solved problem with its variables standing for subexpressions needs no
+  // search
+  if (USE_TEMPLATES && proofTemplates.instantiate(lhs, rhs, result.steps))
+  {
+    result.status = ProofStatus::Proved;
+    return result;
+  }
+
+  if (isDecomposable(lhs, rhs))
+  {
+    result = decomposedSearch(lhs, rhs, deadline, cancelled);
+
+    // a pair of children can fail where the whole problem does not, such as
+    // when only a law across both children applies
+    if (result.status == ProofStatus::NotFound || result.status == ProofStatus::OutOfMemory)
+      result = fallBack(result, searchWhole(lhs, rhs, deadline, cancelled));
+  }
+  else
+    result = searchWhole(lhs, rhs, deadline, cancelled);
+  if (USE_TEMPLATES && result.status == ProofStatus::Proved)
+    proofTemplates.insert(lhs, rhs, result.steps);
+  return result;
+}
+
+/**
+ * @brief Give the variables of an expression new names in the order they
+ * first appear
+ *
+ * @param expr pointer to the current expression
+ * @param renaming reference to the map of variables to their new names
+ */
+static void addRenaming(std::shared_ptr<Expression> expr, std::unordered_map<std::string, std::string> &renaming)
+{
+  if (expr->isVar() && renaming.find(expr->getValue()) == renaming.end())
+  {
+    int index = renaming.size();
+    renaming[expr->getValue()] = std::string(1, 'a' + index);
+  }
+  if (expr->hasLeft())
+    addRenaming(expr->getLeft(), renaming);
+  if (expr->hasRight())
+    addRenaming(expr->getRight(), renaming);
+}
+
+std::unordered_map<std::string, std::string> getRenaming(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
+{
+  std::unordered_map<std::string, std::string> renaming;
+  addRenaming(lhs, renaming);
+  addRenaming(rhs, renaming);
+  return renaming;
+}
+
+std::unordered_map<std::string, std::string> invertRenaming(const std::unordered_map<std::string, std::string> &renaming)
+{
+  std::unordered_map<std::string, std::string> inverse;
+  for (auto name : renaming)
+    inverse[name.second] = name.first;
+  return inverse;
+}
+
+std::shared_ptr<Expression> renameVariables(std::shared_ptr<Expression> expr, const std::unordered_map<std::string, std::string> &renaming)
+{
+  std::string value = expr->getValue();
+  auto name = renaming.find(value);
+  if (expr->isVar() && name != renaming.end())
+    value = name->second;
+
+  std::shared_ptr<Expression> renamed = std::make_shared<Expression>(value);
+  if (expr->hasLeft())
+    renamed->setLeft(renameVariables(expr->getLeft(), renaming), renamed);
+  if (expr->hasRight())
+    renamed->setRight(renameVariables(expr->getRight(), renaming), renamed);
+  return renamed;
+}
+
+std::vector<std::vector<std::string>> renameSteps(const std::vector<std::vector<std::string>> &steps, const std::unordered_map<std::string, std::string> &renaming)
+{
+  std::vector<std::vector<std::string>> renamed;
+  for (auto step : steps)
+  {
+    // the step of a proof of equal expressions has no expression
+    if (step[0].empty())
+    {
+      renamed.push_back(step);
+      continue;
+    }
+    std::shared_ptr<Expression> expr;
+    parse(step[0], expr);
+    renamed.push_back({renameVariables(expr, renaming)->toStringTree(), step[1]});
+  }
+  return renamed;
+}
+
+bool isDecomposable(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs)
+{
+  if (lhs->getValue() != rhs->getValue() || !lhs->hasLeft() || lhs->hasRight() != rhs->hasRight())
+    return false;
+  if (!isEquivalent(lhs->getLeft(), rhs->getLeft()))
+    return false;
+  return !lhs->hasRight() || isEquivalent(lhs->getRight(), rhs->getRight());
+}
+
+/**
+ * @brief Prove a pair of children of decomposable expressions
+ *
+ * @param lhs pointer to the child of the left hand side
+ * @param rhs pointer to the child of the right hand side
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+static ProofResult proveChildren(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  // the steps are lifted into the parent, so a child that is already equal
+  // still needs its own string
+  if (lhs->compare(rhs))
+    return {ProofStatus::Proved, {{lhs->clone()->toStringTree(), "Given"}}, {}};
+
+  // the searches rewrite their expressions as roots, so detach the children
+  return proveEquivalence(lhs->clone(), rhs->clone(), deadline, cancelled);
+}
+
+/**
+ * @brief Turn the steps of a child into steps of its parent
+ *
+ * @param steps steps of the child: {{expr, law},...}
+ * @param value operator of the parent
+ * @param left pointer to the left child of the parent, nullptr for the
+ * rewritten child
+ * @param right pointer to the right child of the parent, nullptr for the
+ * rewritten child or for NOT
+ *
+ * @return the steps of the parent
+ */
+static std::vector<std::vector<std::string>> liftSteps(const std::vector<std::vector<std::string>> &steps, const std::string &value, std::shared_ptr<Expression> left, std::shared_ptr<Expression> right)
+{
+  std::vector<std::vector<std::string>> lifted;
+  for (auto step : steps)
+  {
+    std::shared_ptr<Expression> child;
+    parse(step[0], child);
+
+    std::shared_ptr<Expression> parent = std::make_shared<Expression>(value);
+    parent->setLeft(left ? left->clone() : child, parent);
+    if (right || left)
+      parent->setRight(right ? right->clone() : child, parent);
+    lifted.push_back({parent->toStringTree(), step[1]});
+  }
+  return lifted;
+}
+
+ProofResult decomposedSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Decomposed Search");
+
+  // every level of the tree would start a thread of its own, so the left
+  // pair is only proved on another thread while there are threads to spare
+  bool parallel = lhs->hasRight() && decompositionThreads.fetch_add(1) < MAX_DECOMPOSITION_THREADS;
+  if (lhs->hasRight() && !parallel)
+    decompositionThreads--;
+  std::future<ProofResult> leftProof;
+  ProofResult left;
+  if (parallel)
+    leftProof = std::async(std::launch::async, proveChildren, lhs->getLeft(), rhs->getLeft(), deadline, std::cref(cancelled));
+  else
+    left = proveChildren(lhs->getLeft(), rhs->getLeft(), deadline, cancelled);
+
+  ProofResult right = {ProofStatus::Proved, {}, {}};
+  if (lhs->hasRight())
+    right = proveChildren(lhs->getRight(), rhs->getRight(), deadline, cancelled);
+  if (parallel)
+  {
+    left = leftProof.get();
+    decompositionThreads--;
+  }
+
+  // both pairs were searched at the same time
+  ProofResult result = left;
+  addStats(result.stats, right.stats);
+  result.stats.peakMemory = left.stats.peakMemory + right.stats.peakMemory;
+  result.stats.seconds = std::max(left.stats.seconds, right.stats.seconds);
+  if (left.status != ProofStatus::Proved || right.status != ProofStatus::Proved)
+  {
+    result.status = left.status != ProofStatus::Proved ? left.status : right.status;
+    result.steps.clear();
+    return result;
+  }
+
+  // rewrite the left child while the right child is still the lhs one, then
+  // the right child, whose first step repeats the last one
+  result.steps = liftSteps(left.steps, lhs->getValue(), nullptr, lhs->getRight());
+  if (lhs->hasRight())
+  {
+    std::vector<std::vector<std::string>> rightSteps = liftSteps(right.steps, lhs->getValue(), rhs->getLeft(), nullptr);
+    result.steps.insert(result.steps.end(), rightSteps.begin() + 1, rightSteps.end());
+  }
+  return result;
+}
 
-  std::queue<std::shared_ptr<Expression>> queue;
+/**
+ * @brief Search breadth-first for a shortest proof
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param freeze whether to leave alone the subexpressions that already equal
+ * the rhs
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+static ProofResult searchBreadthFirst(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, bool freeze, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Breadth-First Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  std::queue<SearchState> queue;
   std::unordered_map<std::string, std::pair<std::string, std::string>> visited;
 
-  queue.push(lhs);
-  visited[lhs->toStringTree()] = {"", "Given"};
+  // every level of the search is its own span, so slow levels stand out
+  auto levelStart = startTime;
+  auto traceLevel = [&]()
+  {
+    int depth = result.stats.frontier.size() - 1;
+    Tracer::record("BFS Level " + std::to_string(depth), levelStart, std::chrono::steady_clock::now(), {{"frontier", (double)result.stats.frontier[depth]}});
+  };
+  auto finish = [&](ProofStatus status)
+  {
+    traceLevel();
+    result.status = status;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    span.setArg("expanded", result.stats.expanded);
+    result.stats.phaseSeconds["Breadth-First Search"] = result.stats.seconds;
+    result.stats.peakVisited = visited.size();
+    return result;
+  };
+
+  SearchMemory memory;
+  size_t budget = (size_t)MAX_MEMORY_MB * 1024 * 1024;
 
+  SearchState start = {lhs, {}, {"", nullptr}};
+  findMatches(lhs, "", start.matches);
+  queue.push(start);
+  std::string lhsString = lhs->toStringTree();
+  visited[lhsString] = {"", "Given"};
+  memory.used += stateMemory(start) + visitedMemory(lhsString, visited[lhsString]);
+
+  // the queue holds every state of a level before any of the next one
   bool found = false;
-  
+  size_t levelLeft = 1;
+  result.stats.frontier.push_back(1);
+
   while (!queue.empty())
   {
-    // if queue is too long, stop
-    if (queue.size() > MAX_QUEUE_SIZE)
+    result.stats.peakMemory = std::max(result.stats.peakMemory, memory.used);
+
+    // checked once per expansion so callers can bound the time of a proof
+    if (cancelled.load(std::memory_order_relaxed))
+      return finish(ProofStatus::Cancelled);
+    if (std::chrono::steady_clock::now() >= deadline)
+      return finish(ProofStatus::TimedOut);
+
+    // if memory is running low, store the whole queue compactly
+    if (!memory.compact && memory.used > budget / 2)
     {
-      steps.push_back({"", "Too many steps :("});
-      return steps;
+      memory.compact = true;
+      for (size_t i = queue.size(); i > 0; i--)
+      {
+        SearchState state = queue.front();
+        queue.pop();
+        SearchState compacted = compactState(state);
+        memory.used = memory.used - stateMemory(state) + stateMemory(compacted);
+        queue.push(compacted);
+      }
     }
-    std::shared_ptr<Expression> expr = queue.front();
+
+    // if even the compact queue does not fit, stop
+    if (memory.used > budget)
+      return finish(ProofStatus::OutOfMemory);
+
+    SearchState state = queue.front();
     queue.pop();
+    memory.used -= stateMemory(state);
+    if (!state.expr)
+      expandState(state);
+
+    if (state.expr->compare(rhs))
+    {
+      result.steps = backtrack(visited, state.expr->toStringTree());
+      return finish(ProofStatus::Proved);
+    }
+
+    size_t queued = queue.size();
+    generateNextSteps(state, rhs, found, queue, visited, memory, freeze, &result.stats);
+    result.stats.expanded++;
+    result.stats.generated += queue.size() - queued;
+
+    if (--levelLeft == 0 && !queue.empty())
+    {
+      traceLevel();
+      levelStart = std::chrono::steady_clock::now();
+      levelLeft = queue.size();
+      result.stats.frontier.push_back(queue.size());
+    }
+  }
+  return finish(ProofStatus::NotFound);
+}
+
+ProofResult breadthFirstSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  if (!FREEZE_ALIGNED)
+    return searchBreadthFirst(lhs, rhs, false, deadline, cancelled);
+
+  // the frozen subexpressions may have to change after all
+  ProofResult result = searchBreadthFirst(lhs, rhs, true, deadline, cancelled);
+  if (result.status == ProofStatus::NotFound)
+    result = fallBack(result, searchBreadthFirst(lhs, rhs, false, deadline, cancelled));
+  return result;
+}
+
+/**
+ * @brief State shared by every level of a depth-limited search
+ */
+struct DepthFirstSearch {
+  /**
+   * @brief Pointer to the expression to reach
+   */
+  std::shared_ptr<Expression> rhs;
+
+  /**
+   * @brief Point in time after which the search gives up
+   */
+  std::chrono::steady_clock::time_point deadline;
+
+  /**
+   * @brief Token that stops the search once it is set
+   */
+  const std::atomic<bool> &cancelled;
+
+  /**
+   * @brief Expressions on the current path and their siblings, so that
+   * generateNextSteps never walks back along the path
+   */
+  std::unordered_map<std::string, std::pair<std::string, std::string>> visited;
+
+  /**
+   * @brief Shallowest depth every expression was expanded at in the current
+   * iteration, holds at most TRANSPOSITION_TABLE_SIZE expressions
+   */
+  std::unordered_map<std::string, int> transpositions;
+
+  /**
+   * @brief Steps from the lhs to the current expression: {{expr, law},...}
+   */
+  std::vector<std::vector<std::string>> path;
+
+  /**
+   * @brief Memory used by the path, the siblings and the transposition table
+   */
+  SearchMemory memory;
+
+  /**
+   * @brief Statistics of the whole search
+   */
+  SearchStats &stats;
+
+  /**
+   * @brief Whether the current iteration left out expressions deeper than
+   * its bound
+   */
+  bool cutOff;
+};
+
+/**
+ * @brief Search depth-first from a state for the rhs, without going deeper
+ * than the bound
+ *
+ * @param search reference to the state of the whole search
+ * @param state the state to expand
+ * @param exprString string of the expression of the state
+ * @param depth number of steps from the lhs to the state
+ * @param bound maximum number of steps of the proof
+ *
+ * @return Proved with the proof in search.path, NotFound, TimedOut or
+ * Cancelled
+ */
+static ProofStatus depthLimitedSearch(DepthFirstSearch &search, const SearchState &state, const std::string &exprString, int depth, int bound)
+{
+  if (search.cancelled.load(std::memory_order_relaxed))
+    return ProofStatus::Cancelled;
+  if (std::chrono::steady_clock::now() >= search.deadline)
+    return ProofStatus::TimedOut;
+
+  if (depth == bound)
+  {
+    search.cutOff = true;
+    return ProofStatus::NotFound;
+  }
+
+  // an expression expanded before at this depth or shallower already had at
+  // least as many steps left to reach the rhs
+  auto transposition = search.transpositions.find(exprString);
+  if (transposition != search.transpositions.end() && transposition->second <= depth)
+    return ProofStatus::NotFound;
+  if (transposition != search.transpositions.end())
+    transposition->second = depth;
+  else if ((int)search.transpositions.size() < TRANSPOSITION_TABLE_SIZE)
+  {
+    search.transpositions[exprString] = depth;
+    search.memory.used += sizeof(std::pair<const std::string, int>) + 3 * sizeof(void *) + stringMemory(exprString);
+  }
+
+  std::queue<SearchState> children;
+  bool found = false;
+  generateNextSteps(state, search.rhs, found, children, search.visited, search.memory, false, &search.stats);
+  search.stats.expanded++;
+  search.stats.generated += children.size();
+  search.stats.peakMemory = std::max(search.stats.peakMemory, search.memory.used);
+  search.stats.peakVisited = std::max(search.stats.peakVisited, search.visited.size());
+  if ((int)search.stats.frontier.size() < depth + 2)
+    search.stats.frontier.resize(depth + 2);
+  search.stats.frontier[depth + 1] += children.size();
+
+  if (found)
+  {
+    // the rhs is always the last state generated
+    std::string rhsString = children.back().expr->toStringTree();
+    search.path.push_back({rhsString, search.visited[rhsString].second});
+    return ProofStatus::Proved;
+  }
+
+  while (!children.empty())
+  {
+    SearchState child = children.front();
+    children.pop();
+    search.memory.used -= stateMemory(child);
+
+    std::string childString = child.expr->toStringTree();
+    search.path.push_back({childString, search.visited[childString].second});
+    ProofStatus status = depthLimitedSearch(search, child, childString, depth + 1, bound);
+    if (status != ProofStatus::NotFound)
+      return status;
+    search.path.pop_back();
+
+    search.memory.used -= visitedMemory(childString, search.visited[childString]);
+    search.visited.erase(childString);
+  }
+  return ProofStatus::NotFound;
+}
+
+/**
+ * @brief Search with growing bounds for a proof of at most a number of steps
+ *
+ * @param lhs pointer to left hand side expression
+ * @param rhs pointer to right hand side expression
+ * @param maxLength maximum number of steps of the proof
+ * @param deadline point in time after which the search gives up
+ * @param cancelled token that stops the search once it is set
+ *
+ * @return the status, the steps if proved and the statistics of the search
+ */
+static ProofResult deepeningSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, int maxLength, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Iterative Deepening Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  DepthFirstSearch search = {rhs, deadline, cancelled, {}, {}, {}, {}, result.stats, false};
+
+  SearchState start = {lhs, {}, {"", nullptr}};
+  findMatches(lhs, "", start.matches);
+  std::string lhsString = lhs->toStringTree();
+  result.stats.frontier.push_back(1);
+
+  // every iteration repeats the previous one a step deeper, so the first proof
+  // found is a shortest one
+  for (int bound = 1; bound <= maxLength; bound++)
+  {
+    search.visited = {{lhsString, {"", "Given"}}};
+    search.transpositions.clear();
+    search.path = {{lhsString, "Given"}};
+    search.memory.used = stateMemory(start) + visitedMemory(lhsString, search.visited[lhsString]);
+    search.cutOff = false;
+
+    result.status = depthLimitedSearch(search, start, lhsString, 0, bound);
+    if (result.status == ProofStatus::Proved)
+      result.steps = search.path;
+
+    // stop once nothing was left out, going deeper cannot find anything new
+    if (result.status != ProofStatus::NotFound || !search.cutOff)
+      break;
+  }
+
+  result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  result.stats.phaseSeconds["Iterative Deepening Search"] = result.stats.seconds;
+  return result;
+}
+
+ProofResult iterativeDeepeningSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  return deepeningSearch(lhs, rhs, MAX_PROOF_LENGTH, deadline, cancelled);
+}
+
+ProofResult beamSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Beam Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  std::unordered_map<std::string, std::pair<std::string, std::string>> visited;
+  auto finish = [&](ProofStatus status)
+  {
+    result.status = status;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    span.setArg("expanded", result.stats.expanded);
+    result.stats.phaseSeconds["Beam Search"] = result.stats.seconds;
+    result.stats.peakVisited = visited.size();
+    return result;
+  };
+
+  SearchMemory memory;
+
+  SearchState start = {lhs, {}, {"", nullptr}};
+  findMatches(lhs, "", start.matches);
+  std::string lhsString = lhs->toStringTree();
+  visited[lhsString] = {"", "Given"};
+  memory.used += stateMemory(start) + visitedMemory(lhsString, visited[lhsString]);
+
+  std::vector<SearchState> beam = {start};
+  bool found = false;
+  result.stats.frontier.push_back(1);
+
+  for (int depth = 1; depth <= MAX_PROOF_LENGTH && !beam.empty(); depth++)
+  {
+    std::queue<SearchState> candidates;
+    for (auto &state : beam)
+    {
+      if (cancelled.load(std::memory_order_relaxed))
+        return finish(ProofStatus::Cancelled);
+      if (std::chrono::steady_clock::now() >= deadline)
+        return finish(ProofStatus::TimedOut);
+
+      generateNextSteps(state, rhs, found, candidates, visited, memory, false, &result.stats);
+      result.stats.expanded++;
+      if (found)
+      {
+        result.steps = backtrack(visited, rhs->toStringTree());
+        return finish(ProofStatus::Proved);
+      }
+    }
+    result.stats.generated += candidates.size();
+    result.stats.peakMemory = std::max(result.stats.peakMemory, memory.used);
+    result.stats.frontier.push_back(candidates.size());
 
-    if (expr->compare(rhs))
+    // keep the candidates closest to the rhs, ties in the order they were
+    // generated
+    std::vector<std::pair<int, SearchState>> ranked;
+    while (!candidates.empty())
     {
-      // found the rhs, now backtrack the visited map to get the steps
-      std::string currentExprString = expr->toStringTree();
-      while (currentExprString != "")
+      ranked.push_back({treeDistance(candidates.front().expr, rhs), candidates.front()});
+      candidates.pop();
+    }
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [](const std::pair<int, SearchState> &a, const std::pair<int, SearchState> &b)
+                     { return a.first < b.first; });
+
+    for (auto &state : beam)
+      memory.used -= stateMemory(state);
+    beam.clear();
+    for (size_t i = 0; i < ranked.size(); i++)
+    {
+      if ((int)i >= BEAM_WIDTH)
+        memory.used -= stateMemory(ranked[i].second);
+      else
+        beam.push_back(ranked[i].second);
+    }
+  }
+  return finish(ProofStatus::NotFound);
+}
+
+ProofResult normalFormSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Normal Form Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  auto finish = [&](ProofStatus status)
+  {
+    result.status = status;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    span.setArg("expanded", result.stats.expanded);
+    result.stats.phaseSeconds["Normal Form Search"] = result.stats.seconds;
+    return result;
+  };
+
+  std::set<std::string> variables = lhs->getVariables();
+  std::set<std::string> rhsVariables = rhs->getVariables();
+  variables.insert(rhsVariables.begin(), rhsVariables.end());
+
+  // each side is normalized without interruption, so only check in between
+  std::vector<std::vector<std::string>> sides[2];
+  std::shared_ptr<Expression> expressions[2] = {lhs, rhs};
+  for (int i = 0; i < 2; i++)
+  {
+    if (cancelled.load(std::memory_order_relaxed))
+      return finish(ProofStatus::Cancelled);
+    if (std::chrono::steady_clock::now() >= deadline)
+      return finish(ProofStatus::TimedOut);
+
+    sides[i] = normalize(expressions[i], variables);
+    result.stats.expanded++;
+    result.stats.generated += sides[i].size();
+  }
+
+  if (sides[0].empty() || sides[1].empty() || sides[0].back()[0] != sides[1].back()[0])
+    return finish(ProofStatus::NotFound);
+
+  // walk the rhs steps backwards, each step is justified by the same law
+  std::vector<std::vector<std::string>> steps = sides[0];
+  for (int i = sides[1].size() - 2; i >= 0; i--)
+    steps.push_back({sides[1][i][0], sides[1][i + 1][1]});
+
+  // both sides can pass through the same expression, cut out the loop
+  result.steps = removeLoops(steps);
+  return finish(ProofStatus::Proved);
+}
+
+ProofResult eGraphSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("E-Graph Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  EGraph graph;
+  auto finish = [&](ProofStatus status)
+  {
+    result.status = status;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    span.setArg("expanded", result.stats.expanded);
+    result.stats.phaseSeconds["E-Graph Search"] = result.stats.seconds;
+    result.stats.peakVisited = graph.size();
+    return result;
+  };
+
+  graph.addRules(equivalences);
+  int lhsNode = graph.add(lhs);
+  int rhsNode = graph.add(rhs);
+
+  // every step applies all rules at once, so only check in between
+  while (graph.find(lhsNode) != graph.find(rhsNode))
+  {
+    if (cancelled.load(std::memory_order_relaxed))
+      return finish(ProofStatus::Cancelled);
+    if (std::chrono::steady_clock::now() >= deadline)
+      return finish(ProofStatus::TimedOut);
+
+    int before = graph.size();
+    int merges = graph.step(MAX_EGRAPH_NODES);
+    result.stats.expanded++;
+    result.stats.generated += graph.size() - before;
+
+    // saturated, or full without learning anything new
+    if (merges == 0)
+      return finish(ProofStatus::NotFound);
+  }
+
+  // merges made for other expressions can lead the explanation in a circle
+  result.steps = removeLoops(graph.explain(lhsNode, rhsNode));
+  return finish(ProofStatus::Proved);
+}
+
+ProofResult shortenProof(ProofResult proof, int window, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Shortening");
+  if (proof.status != ProofStatus::Proved)
+    return proof;
+
+  auto startTime = std::chrono::steady_clock::now();
+  std::vector<std::vector<std::string>> &steps = proof.steps;
+  steps = removeLoops(steps);
+
+  // a window that was shortened is tried again from the same start, the proof
+  // gets shorter every time so this ends
+  int start = 0;
+  while (start + 2 < (int)steps.size())
+  {
+    bool shortened = false;
+    for (int end = std::min(start + window, (int)steps.size() - 1); end >= start + 2 && !shortened; end--)
+    {
+      if (cancelled.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline)
       {
-        steps.push_back({currentExprString, visited[currentExprString].second});
-        currentExprString = visited[currentExprString].first;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        proof.stats.seconds += seconds;
+        proof.stats.phaseSeconds["Shortening"] += seconds;
+        return proof;
       }
-      std::reverse(steps.begin(), steps.end());
-      return steps;
+
+      std::shared_ptr<Expression> from;
+      std::shared_ptr<Expression> to;
+      parse(steps[start][0], from);
+      parse(steps[end][0], to);
+      // the windows are timed as part of the shortening
+      ProofResult shorter = deepeningSearch(from, to, end - start - 1, deadline, cancelled);
+      shorter.stats.seconds = 0;
+      shorter.stats.phaseSeconds.clear();
+      shorter.stats.frontier.clear();
+      addStats(proof.stats, shorter.stats);
+      if (shorter.status != ProofStatus::Proved)
+        continue;
+
+      // the first step of the shorter proof is the start of the window
+      steps.erase(steps.begin() + start + 1, steps.begin() + end + 1);
+      steps.insert(steps.begin() + start + 1, shorter.steps.begin() + 1, shorter.steps.end());
+      shortened = true;
     }
+    if (!shortened)
+      start++;
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  proof.stats.seconds += seconds;
+  proof.stats.phaseSeconds["Shortening"] += seconds;
+  return proof;
+}
 
-    generateNextSteps(expr, rhs, found, queue, visited);
+std::vector<std::vector<std::string>> minimizeParentheses(const std::vector<std::vector<std::string>> &steps)
+{
+  std::vector<std::vector<std::string>> minimized;
+  for (auto step : steps)
+  {
+    std::shared_ptr<Expression> expr;
+    parse(step[0], expr);
+    std::string minimal = expr->toStringMinimal();
+    if (minimized.empty() || minimized.back()[0] != minimal)
+      minimized.push_back({minimal, step[1]});
   }
-  return {{"", "Couldn't find a solution :("}};
+  return minimized;
 }
 
-void generateNextSteps(std::shared_ptr<Expression> expr, std::shared_ptr<Expression> end, bool &found, std::queue<std::shared_ptr<Expression>> &queue, std::unordered_map<std::string, std::pair<std::string, std::string>> &visited)
+void addStats(SearchStats &total, const SearchStats &other)
 {
-  for (auto equiv : equivalences)
+  total.expanded += other.expanded;
+  total.generated += other.generated;
+  total.duplicates += other.duplicates;
+  total.lengthRejected += other.lengthRejected;
+  for (auto law : other.lawAttempts)
+    total.lawAttempts[law.first] += law.second;
+  for (auto law : other.lawSuccesses)
+    total.lawSuccesses[law.first] += law.second;
+  if (total.frontier.size() < other.frontier.size())
+    total.frontier.resize(other.frontier.size());
+  for (size_t depth = 0; depth < other.frontier.size(); depth++)
+    total.frontier[depth] += other.frontier[depth];
+  total.peakMemory = std::max(total.peakMemory, other.peakMemory);
+  total.peakVisited = std::max(total.peakVisited, other.peakVisited);
+  total.seconds += other.seconds;
+  for (auto phase : other.phaseSeconds)
+    total.phaseSeconds[phase.first] += phase.second;
+}
+
+std::string jsonString(const std::string &str)
+{
+  std::string quoted = "\"";
+  for (unsigned char c : str)
   {
-    if (found)
-      return;
+    if (c == '"' || c == '\\')
+      quoted += std::string("\\") + char(c);
+    else if (c < 0x20)
+    {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      quoted += escaped;
+    }
+    else
+      quoted += c;
+  }
+  return quoted + "\"";
+}
 
-    auto funct = equiv.first;
-    auto lawName = equiv.second;
+/**
+ * @brief Render a map as a JSON object
+ *
+ * @param map the map
+ *
+ * @return the JSON object
+ */
+template <typename T>
+static std::string jsonObject(const std::map<std::string, T> &map)
+{
+  std::ostringstream json;
+  json << "{";
+  for (auto entry = map.begin(); entry != map.end(); entry++)
+    json << (entry == map.begin() ? "" : ",") << jsonString(entry->first) << ":" << entry->second;
+  json << "}";
+  return json.str();
+}
+
+std::string statsToJson(const SearchStats &stats)
+{
+  std::ostringstream json;
+  json << "{\"expanded\":" << stats.expanded
+       << ",\"generated\":" << stats.generated
+       << ",\"duplicates\":" << stats.duplicates
+       << ",\"lengthRejected\":" << stats.lengthRejected
+       << ",\"lawAttempts\":" << jsonObject(stats.lawAttempts)
+       << ",\"lawSuccesses\":" << jsonObject(stats.lawSuccesses)
+       << ",\"frontier\":[";
+  for (size_t depth = 0; depth < stats.frontier.size(); depth++)
+    json << (depth == 0 ? "" : ",") << stats.frontier[depth];
+  json << "],\"peakMemory\":" << stats.peakMemory
+       << ",\"peakVisited\":" << stats.peakVisited
+       << ",\"seconds\":" << stats.seconds
+       << ",\"phaseSeconds\":" << jsonObject(stats.phaseSeconds) << "}";
+  return json.str();
+}
+
+/**
+ * @brief Collect the paths of every subexpression a law can apply to
+ *
+ * @param expr pointer to the current subexpression
+ * @param position path from the root to the subexpression
+ * @param positions reference to the vector the paths are stored in
+ */
+static void collectPositions(std::shared_ptr<Expression> expr, const std::string &position, std::vector<std::string> &positions)
+{
+  if (expr->isVar())
+    return;
+  positions.push_back(position);
+  if (expr->hasLeft())
+    collectPositions(expr->getLeft(), position + "L", positions);
+  if (expr->hasRight())
+    collectPositions(expr->getRight(), position + "R", positions);
+}
 
-    std::shared_ptr<Expression> newExpr = expr->cloneTree();
+/**
+ * @brief Find the law and the position of a step of a proof
+ *
+ * @param index index of every law the step could use
+ * @param previous string of the expression before the step
+ * @param current string of the expression after the step
+ * @param lawName name of the law of the step
+ * @param step reference to the law and the path from the root it applies to
+ *
+ * @return bool of whether a law with the name gives the expression after the
+ * step
+ */
+static bool identifyStep(const LawIndex &index, const std::string &previous, const std::string &current, const std::string &lawName, EquivLaws::MacroStep &step)
+{
+  std::shared_ptr<Expression> previousExpr;
+  std::shared_ptr<Expression> currentExpr;
+  if (!parse(previous, previousExpr) || !parse(current, currentExpr))
+    return false;
 
-    if (funct(newExpr))
+  std::vector<std::string> positions;
+  collectPositions(previousExpr, "", positions);
+  for (auto position : positions)
+  {
+    for (auto law : index.match(getSubexpression(previousExpr, position)))
     {
-      std::string newExprString = newExpr->toStringTree();
-      if (newExprString.length() > MAX_EXPRESSION_LENGTH)
+      if (EquivLaws::getName(law) != lawName)
+        continue;
+      std::shared_ptr<Expression> newExpr = previousExpr->clone();
+      std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, position);
+      if (!law(subexpression))
+        continue;
+      if (position.empty())
+        newExpr = subexpression;
+      if (newExpr->compare(currentExpr))
+      {
+        step = {law, position};
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+int mineMacros(const std::vector<std::vector<std::vector<std::string>>> &proofs, int count, int minOccurrences)
+{
+  std::unordered_map<EquivLaws::EquivLaw, std::string> laws = EquivLaws::laws;
+  laws.insert(EquivLaws::implications.begin(), EquivLaws::implications.end());
+  laws.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
+  LawIndex index;
+  index.insert(laws);
+
+  // count every pair of consecutive steps where the second step rewrites
+  // inside or above the result of the first, rooted at the higher of the two
+  std::map<std::vector<std::pair<EquivLaws::EquivLaw, std::string>>, int> occurrences;
+  for (auto &proof : proofs)
+  {
+    std::vector<EquivLaws::MacroStep> steps;
+    for (size_t i = 1; i < proof.size(); i++)
+    {
+      EquivLaws::MacroStep step = {nullptr, ""};
+      identifyStep(index, proof[i - 1][0], proof[i][0], proof[i][1], step);
+      steps.push_back(step);
+    }
+
+    for (size_t i = 1; i < steps.size(); i++)
+    {
+      if (!steps[i - 1].law || !steps[i].law)
+        continue;
+      const std::string &first = steps[i - 1].position;
+      const std::string &second = steps[i].position;
+      size_t root = std::min(first.size(), second.size());
+      if (first.compare(0, root, second, 0, root) != 0)
+        continue;
+      occurrences[{{steps[i - 1].law, first.substr(root)}, {steps[i].law, second.substr(root)}}]++;
+    }
+  }
+
+  std::vector<std::pair<int, std::vector<std::pair<EquivLaws::EquivLaw, std::string>>>> frequent;
+  for (auto &pattern : occurrences)
+  {
+    if (pattern.second >= minOccurrences)
+      frequent.push_back({pattern.second, pattern.first});
+  }
+  std::stable_sort(frequent.begin(), frequent.end(), [](const auto &a, const auto &b)
+                   { return a.first > b.first; });
+
+  int added = 0;
+  for (size_t i = 0; i < frequent.size() && added < count; i++)
+  {
+    std::vector<EquivLaws::MacroStep> steps;
+    for (auto step : frequent[i].second)
+      steps.push_back({step.first, step.second});
+    if (!EquivLaws::addMacro(steps))
+      break;
+    added++;
+  }
+  return added;
+}
+
+std::vector<std::vector<std::string>> expandMacros(const std::vector<std::vector<std::string>> &steps)
+{
+  std::vector<std::vector<std::string>> expanded;
+  for (size_t i = 0; i < steps.size(); i++)
+  {
+    std::vector<std::vector<std::string>> primitive;
+    std::shared_ptr<Expression> previous;
+    std::shared_ptr<Expression> current;
+    if (i > 0 && parse(steps[i - 1][0], previous) && parse(steps[i][0], current))
+    {
+      std::vector<std::string> positions;
+      collectPositions(previous, "", positions);
+      for (auto macro : EquivLaws::macros)
+      {
+        if (macro.second != steps[i][1] || !primitive.empty())
+          continue;
+
+        // replay the steps of the macro at every position until one gives
+        // the expression after the step
+        for (auto position : positions)
+        {
+          std::shared_ptr<Expression> newExpr = previous->clone();
+          primitive.clear();
+          for (auto step : EquivLaws::getMacroSteps(macro.first))
+          {
+            std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, position);
+            for (size_t j = 0; j < step.position.size() && subexpression; j++)
+              subexpression = step.position[j] == 'L' ? subexpression->getLeft() : subexpression->getRight();
+            if (!subexpression || !step.law(subexpression))
+            {
+              primitive.clear();
+              break;
+            }
+            if (subexpression->getParent() == nullptr)
+              newExpr = subexpression;
+            primitive.push_back({newExpr->toStringTree(), EquivLaws::getName(step.law)});
+          }
+          if (!primitive.empty() && newExpr->compare(current))
+            break;
+          primitive.clear();
+        }
+      }
+    }
+
+    if (primitive.empty())
+      expanded.push_back(steps[i]);
+    else
+      expanded.insert(expanded.end(), primitive.begin(), primitive.end());
+  }
+  return expanded;
+}
+
+int lawCost(const std::string &lawName)
+{
+  auto cost = LAW_COSTS.find(lawName);
+  return cost == LAW_COSTS.end() ? DEFAULT_LAW_COST : cost->second;
+}
+
+ProofResult uniformCostSearch(std::shared_ptr<Expression> lhs, std::shared_ptr<Expression> rhs, std::chrono::steady_clock::time_point deadline, const std::atomic<bool> &cancelled)
+{
+  TraceSpan span("Uniform-Cost Search");
+  auto startTime = std::chrono::steady_clock::now();
+  ProofResult result = {ProofStatus::NotFound, {}, {}};
+  std::unordered_map<std::string, std::pair<std::string, std::string>> visited;
+  auto finish = [&](ProofStatus status)
+  {
+    result.status = status;
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    span.setArg("expanded", result.stats.expanded);
+    result.stats.phaseSeconds["Uniform-Cost Search"] = result.stats.seconds;
+    result.stats.peakVisited = visited.size();
+    return result;
+  };
+
+  // cheapest first, then in the order the states were generated
+  typedef std::pair<std::pair<int, int>, SearchState> QueuedState;
+  auto later = [](const QueuedState &a, const QueuedState &b)
+  { return a.first > b.first; };
+  std::priority_queue<QueuedState, std::vector<QueuedState>, decltype(later)> queue(later);
+
+  std::unordered_map<std::string, int> costs;
+  SearchMemory memory;
+  size_t budget = (size_t)MAX_MEMORY_MB * 1024 * 1024;
+  int generated = 0;
+
+  SearchState start = {lhs, {}, {"", nullptr}};
+  findMatches(lhs, "", start.matches);
+  queue.push({{0, generated++}, start});
+  std::string lhsString = lhs->toStringTree();
+  visited[lhsString] = {"", "Given"};
+  costs[lhsString] = 0;
+  memory.used += stateMemory(start) + visitedMemory(lhsString, visited[lhsString]);
+
+  while (!queue.empty())
+  {
+    result.stats.peakMemory = std::max(result.stats.peakMemory, memory.used);
+
+    if (cancelled.load(std::memory_order_relaxed))
+      return finish(ProofStatus::Cancelled);
+    if (std::chrono::steady_clock::now() >= deadline)
+      return finish(ProofStatus::TimedOut);
+    if (memory.used > budget)
+      return finish(ProofStatus::OutOfMemory);
+
+    int cost = queue.top().first.first;
+    SearchState state = queue.top().second;
+    queue.pop();
+    memory.used -= stateMemory(state);
+
+    // a cheaper way to the expression was found after this one was queued
+    std::string exprString = state.expr->toStringTree();
+    if (cost > costs[exprString])
+      continue;
+
+    if (state.expr->compare(rhs))
+    {
+      result.steps = backtrack(visited, exprString);
+      return finish(ProofStatus::Proved);
+    }
+    result.stats.expanded++;
+
+    for (auto match : state.matches)
+    {
+      std::shared_ptr<Expression> newExpr;
+      if (!applyMatch(state, match, newExpr, &result.stats))
         continue;
-      // ignore extremely long expressions
 
-      if (visited.find(newExprString) == visited.end())
+      std::string lawName = equivalences[match.law];
+      int newCost = cost + lawCost(lawName);
+      std::string newExprString = newExpr->toStringTree();
+      auto best = costs.find(newExprString);
+      if (best != costs.end() && best->second <= newCost)
       {
-        visited[newExprString] = {expr->toStringTree(), lawName};
-        if (newExpr->compareTree(end))
-          found = true;
-        while (newExpr->getParent())
-          newExpr = newExpr->getParent();
-        queue.push(newExpr);
+        result.stats.duplicates++;
+        continue;
       }
+
+      if (best == costs.end())
+        memory.used += visitedMemory(newExprString, {exprString, lawName}) + sizeof(std::pair<const std::string, int>) + 3 * sizeof(void *);
+      costs[newExprString] = newCost;
+      visited[newExprString] = {exprString, lawName};
+
+      SearchState newState = {newExpr, updateMatches(state.matches, newExpr, match.position), match};
+      memory.used += stateMemory(newState);
+      queue.push({{newCost, generated++}, newState});
+      result.stats.generated++;
     }
   }
+  return finish(ProofStatus::NotFound);
+}
+
+int treeDistance(std::shared_ptr<Expression> a, std::shared_ptr<Expression> b)
+{
+  if (!a && !b)
+    return 0;
+  if (!a)
+    return b->getSize();
+  if (!b)
+    return a->getSize();
+
+  int distance = a->getValue() == b->getValue() ? 0 : 1;
+  int aligned = treeDistance(a->getLeft(), b->getLeft()) + treeDistance(a->getRight(), b->getRight());
+
+  // the order of the operands is only one commutative step away
+  if (a->isBinary() && b->isBinary())
+    aligned = std::min(aligned, treeDistance(a->getLeft(), b->getRight()) + treeDistance(a->getRight(), b->getLeft()));
+  return distance + aligned;
+}
+
+std::shared_ptr<Expression> getSubexpression(std::shared_ptr<Expression> root, const std::string &position)
+{
+  std::shared_ptr<Expression> expr = root;
+  for (char direction : position)
+    expr = direction == 'L' ? expr->getLeft() : expr->getRight();
+  return expr;
+}
+
+void findMatches(std::shared_ptr<Expression> expr, std::string position, std::vector<Match> &matches)
+{
+  // laws never apply to variables
+  if (expr->isVar())
+    return;
+
+  for (auto law : equivalenceIndex.match(expr))
+    matches.push_back({position, law});
+
+  if (expr->hasLeft())
+    findMatches(expr->getLeft(), position + "L", matches);
+  if (expr->hasRight())
+    findMatches(expr->getRight(), position + "R", matches);
+}
+
+std::vector<Match> updateMatches(const std::vector<Match> &matches, std::shared_ptr<Expression> root, const std::string &position)
+{
+  // keep the matches outside of the rewritten subexpression and its ancestors
+  std::vector<Match> kept;
+  for (auto match : matches)
+  {
+    bool inside = match.position.compare(0, position.length(), position) == 0;
+    bool ancestor = position.compare(0, match.position.length(), match.position) == 0;
+    if (!inside && !ancestor)
+      kept.push_back(match);
+  }
+
+  // patterns with repeated variables can see arbitrarily deep, so every
+  // ancestor is matched again
+  std::vector<Match> changed;
+  std::shared_ptr<Expression> expr = root;
+  for (size_t i = 0; i < position.length(); i++)
+  {
+    for (auto law : equivalenceIndex.match(expr))
+      changed.push_back({position.substr(0, i), law});
+    expr = position[i] == 'L' ? expr->getLeft() : expr->getRight();
+  }
+  findMatches(expr, position, changed);
+
+  // both vectors are in preorder and their positions are disjoint
+  std::vector<Match> updated;
+  updated.reserve(kept.size() + changed.size());
+  std::merge(kept.begin(), kept.end(), changed.begin(), changed.end(), std::back_inserter(updated),
+             [](const Match &a, const Match &b)
+             { return a.position < b.position; });
+  return updated;
+}
+
+bool measureStep(std::shared_ptr<Expression> root, const std::string &position, EquivLaws::EquivLaw law, int &size, int &depth)
+{
+  std::vector<std::shared_ptr<Expression>> path = {root};
+  for (char direction : position)
+    path.push_back(direction == 'L' ? path.back()->getLeft() : path.back()->getRight());
+
+  int newSize;
+  int newDepth;
+  if (!LawIndex::measure(law, path.back(), newSize, newDepth))
+    return false;
+
+  size = root->getSize() - path.back()->getSize() + newSize;
 
-  if (!found)
+  // only the depths of the ancestors can change, siblings stay the same
+  for (int i = position.length() - 1; i >= 0; i--)
   {
-    if (expr->getLeft() && !expr->getLeft()->isVar())
-      generateNextSteps(expr->getLeft(), end, found, queue, visited);
-    if (expr->getRight() && !expr->getRight()->isVar())
-      generateNextSteps(expr->getRight(), end, found, queue, visited);
+    std::shared_ptr<Expression> sibling = position[i] == 'L' ? path[i]->getRight() : path[i]->getLeft();
+    if (sibling)
+      newDepth = std::max(newDepth, sibling->getDepth());
+    newDepth++;
   }
+  depth = newDepth;
+  return true;
+}
+
+size_t stateMemory(const SearchState &state)
+{
+  // every node is allocated together with its shared_ptr control block
+  size_t nodeMemory = sizeof(Expression) + 2 * sizeof(void *);
+
+  size_t memory = sizeof(SearchState) + stringMemory(state.exprString) + stringMemory(state.producedBy.position);
+  if (state.expr)
+    memory += state.expr->getSize() * nodeMemory;
+  memory += state.matches.capacity() * sizeof(Match);
+  for (auto &match : state.matches)
+    memory += stringMemory(match.position);
+  return memory;
+}
+
+size_t visitedMemory(const std::string &exprString, const std::pair<std::string, std::string> &parent)
+{
+  // each entry is a hash node with a next pointer, a cached hash and a bucket
+  return sizeof(std::pair<const std::string, std::pair<std::string, std::string>>) + 3 * sizeof(void *) +
+         stringMemory(exprString) + stringMemory(parent.first) + stringMemory(parent.second);
+}
+
+SearchState compactState(const SearchState &state)
+{
+  if (!state.expr)
+    return state;
+  return {nullptr, {}, state.producedBy, state.expr->toStringTree()};
+}
+
+void expandState(SearchState &state)
+{
+  parse(state.exprString, state.expr);
+  state.matches.clear();
+  findMatches(state.expr, "", state.matches);
+  state.exprString.clear();
+}
+
+bool applyMatch(const SearchState &state, const Match &match, std::shared_ptr<Expression> &newExpr, SearchStats *stats)
+{
+  // the law that would take the expression straight back to its parent
+  auto inverse = EquivLaws::inverses.find(state.producedBy.law);
+  if (inverse != EquivLaws::inverses.end() && match.law == inverse->second && match.position == state.producedBy.position)
+    return false;
+
+  std::string lawName = stats ? equivalences[match.law] : "";
+  if (stats)
+    stats->lawAttempts[lawName]++;
+
+  // ignore expressions that would be too large
+  int size;
+  int depth;
+  if (measureStep(state.expr, match.position, match.law, size, depth) && (size > MAX_NODES || depth > MAX_DEPTH))
+  {
+    if (stats)
+    {
+      stats->lawSuccesses[lawName]++;
+      stats->lengthRejected++;
+    }
+    return false;
+  }
+
+  newExpr = state.expr->clone();
+  std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, match.position);
+  bool applied;
+  if (!rules::apply(match.law, subexpression, applied))
+    applied = match.law(subexpression);
+  if (!applied)
+    return false;
+
+  if (match.position.empty())
+    newExpr = subexpression;
+  if (stats)
+    stats->lawSuccesses[lawName]++;
+
+  // laws without patterns can only be measured once applied
+  if (newExpr->getSize() > MAX_NODES || newExpr->getDepth() > MAX_DEPTH)
+  {
+    if (stats)
+      stats->lengthRejected++;
+    return false;
+  }
+  return true;
+}
+
+void generateNextSteps(const SearchState &state, std::shared_ptr<Expression> end, bool &found, std::queue<SearchState> &queue, std::unordered_map<std::string, std::pair<std::string, std::string>> &visited, SearchMemory &memory, bool freeze, SearchStats *stats)
+{
+  std::string exprString = state.expr->toStringTree();
+  std::vector<std::string> frozen;
+  if (freeze)
+    frozen = findFrozen(state.expr, end);
+
+  for (auto match : state.matches)
+  {
+    if (found)
+      return;
+
+    // a match is inside a frozen subexpression if its path starts with the
+    // path of the subexpression
+    auto isInside = [&](const std::string &position)
+    { return match.position.compare(0, position.size(), position) == 0; };
+    if (std::any_of(frozen.begin(), frozen.end(), isInside))
+      continue;
+
+    std::shared_ptr<Expression> newExpr;
+    if (!applyMatch(state, match, newExpr, stats))
+      continue;
+
+    std::string newExprString = newExpr->toStringTree();
+    if (visited.find(newExprString) != visited.end())
+    {
+      if (stats)
+        stats->duplicates++;
+    }
+    else
+    {
+      visited[newExprString] = {exprString, equivalences[match.law]};
+      if (newExpr->compareTree(end))
+        found = true;
+
+      SearchState newState;
+      if (memory.compact)
+        newState = {nullptr, {}, match, newExprString};
+      else
+        newState = {newExpr, updateMatches(state.matches, newExpr, match.position), match};
+      memory.used += stateMemory(newState) + visitedMemory(newExprString, visited[newExprString]);
+      queue.push(newState);
+    }
+  }
+}
+
+/**
+ * @brief Collect the frozen subexpressions of an expression
+ *
+ * @param expr pointer to the current subexpression
+ * @param end pointer to the subexpression of the end expression at the same
+ * position
+ * @param position path from the root to the current subexpression
+ * @param frozen reference to the vector the paths are appended to
+ */
+static void collectFrozen(std::shared_ptr<Expression> expr, std::shared_ptr<Expression> end, const std::string &position, std::vector<std::string> &frozen)
+{
+  if (expr->compare(end))
+  {
+    frozen.push_back(position);
+    return;
+  }
+  if (expr->getValue() != end->getValue())
+    return;
+  if (expr->hasLeft() && end->hasLeft())
+    collectFrozen(expr->getLeft(), end->getLeft(), position + "L", frozen);
+  if (expr->hasRight() && end->hasRight())
+    collectFrozen(expr->getRight(), end->getRight(), position + "R", frozen);
+}
+
+std::vector<std::string> findFrozen(std::shared_ptr<Expression> expr, std::shared_ptr<Expression> end)
+{
+  std::vector<std::string> frozen;
+  collectFrozen(expr, end, "", frozen);
+  return frozen;
 }
@@ -0,0 +1,110 @@
+/**
+ * @file tracer.cpp
+ * @brief Implementation file for tracer class
+ */
+
+#include "../include/tracer.h"
+#include "../include/solver.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+std::atomic<bool> Tracer::enabled(false);
+std::string Tracer::path;
+std::chrono::steady_clock::time_point Tracer::origin;
+std::vector<Tracer::Event> Tracer::events;
+std::map<std::thread::id, int> Tracer::threads;
+std::mutex Tracer::lock;
+
+void Tracer::start(const std::string &path)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  Tracer::path = path;
+  origin = std::chrono::steady_clock::now();
+  events.clear();
+  threads.clear();
+  enabled = true;
+
+  // a run that ends early still writes what it recorded
+  static bool stopsAtExit = false;
+  if (!stopsAtExit)
+  {
+    std::atexit([]()
+                { Tracer::stop(); });
+    stopsAtExit = true;
+  }
+}
+
+bool Tracer::stop()
+{
+  if (!enabled.exchange(false))
+    return false;
+
+  std::string json = toJson();
+  std::lock_guard<std::mutex> guard(lock);
+  std::ofstream file(path);
+  file << json << std::endl;
+  return file.good();
+}
+
+bool Tracer::isEnabled()
+{
+  return enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::record(const std::string &name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, const std::map<std::string, double> &args)
+{
+  if (!isEnabled())
+    return;
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto thread = threads.insert({std::this_thread::get_id(), threads.size() + 1}).first;
+  long long beginMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(begin - origin).count();
+  long long duration = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+  events.push_back({name, beginMicroseconds, duration, thread->second, args});
+}
+
+std::string Tracer::toJson()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  std::ostringstream json;
+  json << "{\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); i++)
+  {
+    const Event &event = events[i];
+    json << (i == 0 ? "" : ",\n") << "{\"name\":" << jsonString(event.name) << ",\"cat\":\"LogiXpr\",\"ph\":\"X\""
+         << ",\"ts\":" << event.begin << ",\"dur\":" << event.duration << ",\"pid\":1,\"tid\":" << event.thread;
+    if (!event.args.empty())
+    {
+      json << ",\"args\":{";
+      for (auto arg = event.args.begin(); arg != event.args.end(); arg++)
+        json << (arg == event.args.begin() ? "" : ",") << jsonString(arg->first) << ":" << arg->second;
+      json << "}";
+    }
+    json << "}";
+  }
+  json << "],\"displayTimeUnit\":\"ms\"}";
+  return json.str();
+}
+
+TraceSpan::TraceSpan(const std::string &name)
+{
+  // spans that begin while not recording stay empty
+  if (Tracer::isEnabled())
+  {
+    this->name = name;
+    this->begin = std::chrono::steady_clock::now();
+  }
+}
+
+TraceSpan::~TraceSpan()
+{
+  if (!this->name.empty())
+    Tracer::record(this->name, this->begin, std::chrono::steady_clock::now(), this->args);
+}
+
+void TraceSpan::setArg(const std::string &key, double value)
+{
+  if (!this->name.empty())
+    this->args[key] = value;
+}
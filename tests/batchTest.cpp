@@ -0,0 +1,62 @@
+#include "../include/batch.h"
+#include "../include/solver.h"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sstream>
+
+
+static std::vector<std::string> lines(const std::string &str)
+{
+  std::vector<std::string> split;
+  std::istringstream stream(str);
+  std::string line;
+  while (std::getline(stream, line))
+    split.push_back(line);
+  return split;
+}
+
+TEST(BatchTest, ProveBatch) {
+  std::istringstream input(
+      "# comment\n"
+      "p -> q ; !q -> !p\n"
+      "\n"
+      "p & q ; q | p\n"
+      "p & ; p\n"
+      "no separator\n"
+      "  (p & q) & r ; p & (q & r)  \n"
+      "p <=> q ; q <=> p\n");
+  std::ostringstream output;
+  EXPECT_EQ(6, proveBatch(input, output, 4, 10));
+
+  // in the order read, whatever order they were proved in
+  std::vector<std::string> results = lines(output.str());
+  ASSERT_EQ(6, results.size());
+  EXPECT_EQ(0, results[0].find("{\"line\":2,\"lhs\":\"p -> q\",\"rhs\":\"!q -> !p\",\"status\":\"proved\",\"steps\":[{\"expression\":\"p -> q\",\"law\":\"Given\"}"));
+  EXPECT_EQ(0, results[1].find("{\"line\":4,\"lhs\":\"p & q\",\"rhs\":\"q | p\",\"status\":\"not equivalent\",\"seconds\":"));
+  EXPECT_NE(std::string::npos, results[2].find("\"line\":5,\"lhs\":\"p &\",\"rhs\":\"p\",\"status\":\"invalid\""));
+  EXPECT_NE(std::string::npos, results[3].find("\"line\":6,\"lhs\":\"no separator\",\"rhs\":\"\",\"status\":\"invalid\""));
+  EXPECT_NE(std::string::npos, results[4].find("\"line\":7,\"lhs\":\"(p & q) & r\",\"rhs\":\"p & (q & r)\",\"status\":\"proved\""));
+  EXPECT_NE(std::string::npos, results[5].find("\"status\":\"proved\""));
+}
+
+TEST(BatchTest, Cache) {
+  std::string path = (std::filesystem::temp_directory_path() / "logixprBatchTest.bin").string();
+  std::filesystem::remove(path);
+  ProofCache cache;
+  ASSERT_TRUE(cache.open(path));
+
+  // the second pair is a renaming of the first, answered from the cache
+  // once the first window is written
+  std::istringstream first("p -> q ; !p | q\n");
+  std::ostringstream output;
+  proveBatch(first, output, 2, 10, &cache);
+  EXPECT_EQ(1, cache.size());
+  std::istringstream second("a -> b ; !a | b\n");
+  proveBatch(second, output, 2, 10, &cache);
+  EXPECT_EQ(1, cache.size());
+
+  std::vector<std::string> results = lines(output.str());
+  ASSERT_EQ(2, results.size());
+  EXPECT_NE(std::string::npos, results[1].find("{\"expression\":\"!a | b\",\"law\":\"Implication Equivalence\"}"));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,110 @@
+#include "../include/distanceTable.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+
+static std::string tablePath()
+{
+  return (std::filesystem::temp_directory_path() / "logixprDistanceTableTest.bin").string();
+}
+
+static std::shared_ptr<Expression> parseString(std::string str)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return expr;
+}
+
+// collects the paths of every operator of an expression
+static void collectPositions(std::shared_ptr<Expression> expr, std::string position, std::vector<std::string> &positions)
+{
+  if (expr->isVar())
+    return;
+  positions.push_back(position);
+  if (expr->hasLeft())
+    collectPositions(expr->getLeft(), position + "L", positions);
+  if (expr->hasRight())
+    collectPositions(expr->getRight(), position + "R", positions);
+}
+
+// checks that every step follows from the previous one by a single law
+static bool isValidSteps(const std::vector<std::vector<std::string>> &steps)
+{
+  std::unordered_map<EquivLaws::EquivLaw, std::string> laws = EquivLaws::laws;
+  laws.insert(EquivLaws::implications.begin(), EquivLaws::implications.end());
+  laws.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
+  LawIndex index;
+  index.insert(laws);
+
+  for (size_t i = 1; i < steps.size(); i++)
+  {
+    std::shared_ptr<Expression> previous = parseString(steps[i - 1][0]);
+    std::shared_ptr<Expression> current = parseString(steps[i][0]);
+    std::vector<std::string> positions;
+    collectPositions(previous, "", positions);
+
+    bool valid = false;
+    for (auto position : positions)
+    {
+      for (auto law : index.match(getSubexpression(previous, position)))
+      {
+        if (laws[law] != steps[i][1])
+          continue;
+        std::shared_ptr<Expression> newExpr = previous->clone();
+        std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, position);
+        if (!law(subexpression))
+          continue;
+        if (position.empty())
+          newExpr = subexpression;
+        valid = valid || newExpr->compare(current);
+      }
+    }
+    if (!valid)
+      return false;
+  }
+  return true;
+}
+
+TEST(DistanceTableTest, Encode) {
+  uint64_t key;
+  ASSERT_TRUE(DistanceTable::encode(parseString("(a -> !b) & T"), 2, key));
+  EXPECT_EQ(parseString("(a -> !b) & T")->toStringTree(), DistanceTable::decode(key)->toStringTree());
+  EXPECT_FALSE(DistanceTable::encode(parseString("a & c"), 2, key));
+  EXPECT_FALSE(DistanceTable::encode(parseString("!!!!!!!!!!!!!!!!a"), 2, key));
+}
+
+TEST(DistanceTableTest, BuildAndFind) {
+  std::filesystem::remove(tablePath());
+  DistanceTable table;
+  std::vector<std::vector<std::string>> steps;
+  EXPECT_FALSE(table.find(parseString("a & b"), parseString("b & a"), steps));
+  EXPECT_FALSE(DistanceTable::build(tablePath(), 0, 2));
+
+  ASSERT_TRUE(DistanceTable::build(tablePath(), 5, 2));
+  ASSERT_TRUE(table.open(tablePath()));
+  EXPECT_EQ(4020, table.size());
+
+  ASSERT_TRUE(table.find(parseString("a -> b"), parseString("!b -> !a"), steps));
+  EXPECT_EQ(parseString("a -> b")->toStringTree(), steps.front()[0]);
+  EXPECT_EQ(parseString("!b -> !a")->toStringTree(), steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+
+  ASSERT_TRUE(table.find(parseString("!(a & b)"), parseString("!a | !b"), steps));
+  EXPECT_EQ(parseString("!a | !b")->toStringTree(), steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+
+  // not equivalent, too large and other variables
+  EXPECT_FALSE(table.find(parseString("a & b"), parseString("a | b"), steps));
+  EXPECT_FALSE(table.find(parseString("(a & b) | (a & b)"), parseString("a & b"), steps));
+  EXPECT_FALSE(table.find(parseString("a & c"), parseString("c & a"), steps));
+  table.close();
+  EXPECT_EQ(0, table.size());
+
+  // a file cut short is not a table
+  std::filesystem::resize_file(tablePath(), std::filesystem::file_size(tablePath()) - 1);
+  EXPECT_FALSE(table.open(tablePath()));
+  std::filesystem::remove(tablePath());
+}
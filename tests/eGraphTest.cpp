@@ -0,0 +1,174 @@
+#include "../include/eGraph.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include <gtest/gtest.h>
+
+
+// checks that a law with the name turns one expression into the other at
+// some position, in either direction
+static bool follows(std::string from, std::string to, std::string lawName)
+{
+  std::vector<EquivLaws::EquivLaw> laws;
+  for (auto map : {&EquivLaws::laws, &EquivLaws::implications, &EquivLaws::bidirectionalImplications})
+    for (auto law : *map)
+      if (law.second == lawName)
+        laws.push_back(law.first);
+
+  for (int direction = 0; direction < 2; direction++)
+  {
+    std::shared_ptr<Expression> previous;
+    std::shared_ptr<Expression> current;
+    parse(direction ? to : from, previous);
+    parse(direction ? from : to, current);
+
+    std::vector<std::string> positions = {""};
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      std::shared_ptr<Expression> subexpression = getSubexpression(previous, positions[i]);
+      if (subexpression->hasLeft())
+        positions.push_back(positions[i] + "L");
+      if (subexpression->hasRight())
+        positions.push_back(positions[i] + "R");
+
+      for (auto law : laws)
+      {
+        std::shared_ptr<Expression> newExpr = previous->clone();
+        std::shared_ptr<Expression> newSubexpression = getSubexpression(newExpr, positions[i]);
+        if (!law(newSubexpression))
+          continue;
+        if (positions[i].empty())
+          newExpr = newSubexpression;
+        if (newExpr->compare(current))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+static bool isValidSteps(const std::vector<std::vector<std::string>> &steps)
+{
+  for (size_t i = 1; i < steps.size(); i++)
+  {
+    if (!follows(steps[i - 1][0], steps[i][0], steps[i][1]))
+    {
+      ADD_FAILURE() << steps[i - 1][0] << " to " << steps[i][0] << " by " << steps[i][1];
+      return false;
+    }
+  }
+  return true;
+}
+
+static int addString(EGraph &graph, std::string str)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return graph.add(expr);
+}
+
+// saturates the e-graph until both expressions are in the same e-class
+static bool saturate(EGraph &graph, int a, int b, int maxNodes)
+{
+  while (graph.find(a) != graph.find(b))
+  {
+    if (graph.step(maxNodes) == 0)
+      return false;
+  }
+  return true;
+}
+
+TEST(EGraphTest, Add) {
+  EGraph graph;
+  int a = addString(graph, "(p & q) | (p & q)");
+  EXPECT_EQ(4, graph.size());
+  EXPECT_EQ(4, graph.classCount());
+
+  // the same expression is never stored twice
+  EXPECT_EQ(a, addString(graph, "(p & q) | (p & q)"));
+  EXPECT_EQ(4, graph.size());
+  EXPECT_NE(a, addString(graph, "p & q"));
+  EXPECT_EQ(4, graph.size());
+}
+
+TEST(EGraphTest, Congruence) {
+  EGraph graph;
+  int lhs = addString(graph, "!(p & q)");
+  int rhs = addString(graph, "!(q & r)");
+  EXPECT_NE(graph.find(lhs), graph.find(rhs));
+
+  EXPECT_TRUE(graph.merge(addString(graph, "p"), addString(graph, "r"), EquivLaws::identity));
+  EXPECT_FALSE(graph.merge(addString(graph, "p"), addString(graph, "r"), EquivLaws::identity));
+  EXPECT_NE(graph.find(lhs), graph.find(rhs));
+
+  // p & q and q & r only become congruent once q and p are merged as well
+  graph.merge(addString(graph, "q"), addString(graph, "p"), EquivLaws::identity);
+  EXPECT_EQ(2, graph.rebuild());
+  EXPECT_EQ(graph.find(lhs), graph.find(rhs));
+  EXPECT_EQ(0, graph.rebuild());
+}
+
+TEST(EGraphTest, Step) {
+  EGraph graph;
+  graph.addRule(EquivLaws::commutative);
+  int lhs = addString(graph, "(p | q) & r");
+  int rhs = addString(graph, "r & (q | p)");
+  EXPECT_TRUE(saturate(graph, lhs, rhs, 1000));
+
+  // commutativity only ever reaches four expressions
+  while (graph.step(1000) > 0)
+    ;
+  EXPECT_EQ(0, graph.step(1000));
+  EXPECT_EQ(5, graph.classCount());
+
+  // a full e-graph does not grow
+  EGraph full;
+  full.addRules(EquivLaws::laws);
+  addString(full, "(p | q) & (r | s)");
+  int size = full.size();
+  EXPECT_EQ(0, full.step(size));
+  EXPECT_EQ(size, full.size());
+}
+
+TEST(EGraphTest, Explain) {
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"p & (q | r)", "(r & p) | (q & p)"},
+      {"!(p | q) & p", "F"},
+      {"p -> q", "!q -> !p"},
+      {"(p -> q) & (p -> r)", "p -> (q & r)"},
+      {"p <=> q", "(p -> q) & (q -> p)"}};
+
+  for (auto pair : pairs) {
+    EGraph graph;
+    graph.addRules(EquivLaws::laws);
+    graph.addRules(EquivLaws::implications);
+    graph.addRules(EquivLaws::bidirectionalImplications);
+    int lhs = addString(graph, pair.first);
+    int rhs = addString(graph, pair.second);
+    ASSERT_TRUE(saturate(graph, lhs, rhs, 20000)) << pair.first;
+
+    std::vector<std::vector<std::string>> steps = graph.explain(lhs, rhs);
+    std::shared_ptr<Expression> expr;
+    parse(pair.first, expr);
+    EXPECT_EQ(expr->toStringTree(), steps.front()[0]);
+    EXPECT_EQ("Given", steps.front()[1]);
+    parse(pair.second, expr);
+    EXPECT_EQ(expr->toStringTree(), steps.back()[0]);
+    EXPECT_TRUE(isValidSteps(steps)) << pair.first;
+  }
+
+  EGraph graph;
+  EXPECT_TRUE(graph.explain(addString(graph, "p"), addString(graph, "q")).empty());
+}
+
+TEST(EGraphTest, SoundRules) {
+  // no sound rule can merge expressions that are not equivalent, even with
+  // laws that are not valid in both directions
+  EGraph graph;
+  graph.addRules(EquivLaws::laws);
+  graph.addRules(EquivLaws::implications);
+  graph.addRules(EquivLaws::bidirectionalImplications);
+  int lhs = addString(graph, "p -> q");
+  int rhs = addString(graph, "q -> p");
+  EXPECT_FALSE(saturate(graph, lhs, rhs, 3000));
+  EXPECT_NE(graph.find(lhs), graph.find(rhs));
+}
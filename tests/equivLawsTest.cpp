@@ -1846,4 +1846,72 @@ TEST(EquivLawsTest, BidirectionalImplication4ReversedComplex) {
   EXPECT_TRUE(EquivLaws::bidirectionalImplication4Reversed(expr));
   parse("!(p<=>(q<=>r))", expected);
   EXPECT_TRUE(expr->compare(expected));
-}
\ No newline at end of file
+}
+
+TEST(EquivLawsTest, Inverses) {
+  std::vector<std::string> corpus = {
+      "p & q", "(p | q) | r", "p & (q | r)", "(p | q) & (p | r)",
+      "(p & q) | (p & r)", "!(p & q)", "!p | !q", "p -> q", "!p | q",
+      "!q -> !p", "!p -> q", "!(p -> !q)", "p & !q", "(p -> q) & (p -> r)",
+      "(p | q) -> r", "(p -> q) | (q -> r)", "(p & q) -> r", "p <=> q",
+      "!p <=> !q", "!(p <=> q)", "p <=> !q"};
+
+  for (auto inverse : EquivLaws::inverses) {
+    for (auto str : corpus) {
+      std::shared_ptr<Expression> expr;
+      std::shared_ptr<Expression> expected;
+      parse(str, expr);
+      parse(str, expected);
+
+      if (!inverse.first(expr))
+        continue;
+      // the law is applied to a fresh copy, like the solver does
+      expr = expr->clone();
+      EXPECT_TRUE(inverse.second(expr)) << str;
+      EXPECT_TRUE(expr->compare(expected)) << str;
+    }
+  }
+}
+
+TEST(EquivLawsTest, GetName) {
+  EXPECT_EQ("Distributive Law", EquivLaws::getName(EquivLaws::distributiveReversed));
+  EXPECT_EQ("Implication Equivalence", EquivLaws::getName(EquivLaws::implication3));
+  EXPECT_EQ("Bidirectional Implication Equivalence", EquivLaws::getName(EquivLaws::bidirectionalImplication4));
+  EXPECT_EQ("", EquivLaws::getName(nullptr));
+}
+
+TEST(EquivLawsTest, Macros) {
+  std::shared_ptr<Expression> expr;
+  std::shared_ptr<Expression> expected;
+  EquivLaws::clearMacros();
+  EXPECT_EQ(nullptr, EquivLaws::addMacro({{EquivLaws::commutative, ""}}));
+
+  // p -> q = !p | q = q | !p
+  EquivLaws::EquivLaw macro = EquivLaws::addMacro({{EquivLaws::implication0, ""}, {EquivLaws::commutative, ""}});
+  ASSERT_NE(nullptr, macro);
+  EXPECT_EQ("Implication Equivalence + Commutative Law", EquivLaws::getName(macro));
+  EXPECT_EQ(2, EquivLaws::getMacroSteps(macro).size());
+
+  parse("r & (p -> q)", expr);
+  std::shared_ptr<Expression> right = expr->getRight();
+  EXPECT_TRUE(macro(right));
+  parse("r & (q | !p)", expected);
+  EXPECT_TRUE(expr->compare(expected));
+
+  // !q | r = q -> r, but the second step does not apply to p & q
+  EquivLaws::EquivLaw partial = EquivLaws::addMacro({{EquivLaws::implication0Reversed, "R"}, {EquivLaws::deMorgan, "L"}});
+  parse("(p & q) & (!q | r)", expr);
+  EXPECT_FALSE(partial(expr));
+  parse("(p & q) & (!q | r)", expected);
+  EXPECT_TRUE(expr->compare(expected));
+
+  for (int i = 2; i < EquivLaws::MAX_MACROS; i++)
+    EXPECT_NE(nullptr, EquivLaws::addMacro({{EquivLaws::commutative, ""}, {EquivLaws::identity, ""}}));
+  EXPECT_EQ(nullptr, EquivLaws::addMacro({{EquivLaws::commutative, ""}, {EquivLaws::identity, ""}}));
+  EXPECT_EQ(EquivLaws::MAX_MACROS, EquivLaws::macros.size());
+
+  EquivLaws::clearMacros();
+  EXPECT_TRUE(EquivLaws::macros.empty());
+  EXPECT_TRUE(EquivLaws::getMacroSteps(macro).empty());
+  EXPECT_FALSE(macro(expr));
+}
@@ -51,6 +51,29 @@ TEST(ExpressionTest, IsVar) {
   EXPECT_FALSE(expr4->isVar());
 }
 
+TEST(ExpressionTest, GetSizeAndDepth) {
+  std::shared_ptr<Expression> expr = std::make_shared<Expression>("&");
+  EXPECT_EQ(1, expr->getSize());
+  EXPECT_EQ(1, expr->getDepth());
+
+  std::shared_ptr<Expression> left = std::make_shared<Expression>("!");
+  expr->setLeft(left, expr);
+  expr->setRight(std::make_shared<Expression>("q"), expr);
+  EXPECT_EQ(3, expr->getSize());
+  EXPECT_EQ(2, expr->getDepth());
+
+  // changes below are passed up to the root
+  left->setLeft(std::make_shared<Expression>("p"), left);
+  EXPECT_EQ(2, left->getSize());
+  EXPECT_EQ(4, expr->getSize());
+  EXPECT_EQ(3, expr->getDepth());
+
+  expr->setLeft(std::make_shared<Expression>("p"), expr);
+  EXPECT_EQ(3, expr->getSize());
+  EXPECT_EQ(2, expr->getDepth());
+  EXPECT_EQ(3, expr->clone()->getSize());
+}
+
 TEST(ExpressionTest, GetParent) {
   std::shared_ptr<Expression> expr1 = std::make_shared<Expression>("&");
   EXPECT_EQ(nullptr, expr1->getParent());
@@ -251,4 +274,10 @@ TEST(ExpressionTest, ToStringMinimal) {
   expr4->setLeft(std::make_shared<Expression>("p"), expr4);
   expr4->setRight(std::make_shared<Expression>("q"), expr4);
   EXPECT_EQ("p -> q", expr4->toStringMinimal());
+
+  // implications are grouped from the left
+  std::shared_ptr<Expression> expr5 = std::make_shared<Expression>("->");
+  expr5->setLeft(std::make_shared<Expression>("r"), expr5);
+  expr5->setRight(expr4, expr5);
+  EXPECT_EQ("r -> (p -> q)", expr5->toStringMinimal());
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "../include/lawIndex.h"
+#include "../include/parser.h"
+#include <gtest/gtest.h>
+
+
+static std::unordered_map<EquivLaws::EquivLaw, std::string> allLaws()
+{
+  std::unordered_map<EquivLaws::EquivLaw, std::string> laws;
+  laws.insert(EquivLaws::laws.begin(), EquivLaws::laws.end());
+  laws.insert(EquivLaws::implications.begin(), EquivLaws::implications.end());
+  laws.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
+  return laws;
+}
+
+static bool contains(const std::vector<EquivLaws::EquivLaw> &laws, EquivLaws::EquivLaw law)
+{
+  return std::find(laws.begin(), laws.end(), law) != laws.end();
+}
+
+static bool alwaysApplies([[maybe_unused]] std::shared_ptr<Expression> &expression)
+{
+  return true;
+}
+
+TEST(LawIndexTest, EveryLawHasPatterns) {
+  for (auto law : allLaws())
+    EXPECT_NE(LawIndex::patterns.end(), LawIndex::patterns.find(law.first)) << law.second;
+}
+
+// puts a different subexpression in place of every pattern variable
+static std::shared_ptr<Expression> instantiate(std::shared_ptr<Expression> pattern)
+{
+  std::string str = "(" + pattern->toStringTree() + ")";
+  std::vector<std::pair<std::string, std::string>> replacements = {
+      {"(p)", "(a & b)"}, {"(q)", "(!c)"}, {"(r)", "(d | e)"}, {"(s)", "(f -> g)"}};
+  for (auto replacement : replacements)
+    for (size_t i = str.find(replacement.first); i != std::string::npos; i = str.find(replacement.first, i + replacement.second.size()))
+      str.replace(i, replacement.first.size(), replacement.second);
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return expr;
+}
+
+TEST(LawIndexTest, PatternsAgreeWithLaws) {
+  // every pattern is matched by its law, which rewrites it into the right
+  // hand side of the first pattern of the law that matches
+  for (auto lawPatterns : LawIndex::patterns)
+  {
+    const std::string &name = EquivLaws::getName(lawPatterns.first);
+    for (auto pattern : lawPatterns.second)
+    {
+      for (bool substituted : {false, true})
+      {
+        std::shared_ptr<Expression> lhs = substituted ? instantiate(pattern.lhs) : pattern.lhs->clone();
+        std::string lhsString = lhs->toStringTree();
+        ASSERT_TRUE(pattern.matches(lhs)) << name << ": " << lhsString;
+
+        auto first = std::find_if(lawPatterns.second.begin(), lawPatterns.second.end(), [&](const rules::RulePattern &other)
+                                  { return other.matches(lhs); });
+        std::shared_ptr<Expression> expected = substituted ? instantiate(first->rhs) : first->rhs->clone();
+        std::shared_ptr<Expression> actual = lhs->clone();
+        ASSERT_TRUE(lawPatterns.first(actual)) << name << ": " << lhsString;
+        EXPECT_TRUE(expected->compare(actual)) << name << ": " << lhsString << " became " << actual->toStringTree();
+
+        int size;
+        int depth;
+        ASSERT_TRUE(LawIndex::measure(lawPatterns.first, lhs, size, depth)) << name << ": " << lhsString;
+        EXPECT_EQ(actual->getSize(), size) << name << ": " << lhsString;
+        EXPECT_EQ(actual->getDepth(), depth) << name << ": " << lhsString;
+      }
+    }
+  }
+}
+
+TEST(LawIndexTest, Empty) {
+  LawIndex index;
+  std::shared_ptr<Expression> expr;
+
+  parse("p & q", expr);
+  EXPECT_EQ(0, index.size());
+  EXPECT_TRUE(index.match(expr).empty());
+}
+
+TEST(LawIndexTest, MatchesSameLawsAsBruteForce) {
+  std::vector<std::string> corpus = {
+      "p", "T", "!p", "!!p", "p & T", "p | F", "(p | q) & (p | r)",
+      "!(p & q)", "!p | !q", "p | (p & q)", "p & !p", "(p -> q) & (q -> p)",
+      "(p -> q) & (q -> r)", "(p & q) | (!p & !q)", "!(p <=> q)",
+      "p <=> !q", "p ^ q", "(p & q) & (p & q)", "(p & q) -> ((r | s) -> !t)",
+      "!(!(p -> q) | (q <=> p))"};
+
+  auto laws = allLaws();
+  LawIndex index;
+  index.insert(laws);
+  EXPECT_EQ(laws.size(), index.size());
+
+  for (auto str : corpus) {
+    std::shared_ptr<Expression> expr;
+    parse(str, expr);
+    std::vector<EquivLaws::EquivLaw> matched = index.match(expr);
+
+    for (auto law : laws) {
+      std::shared_ptr<Expression> newExpr = expr->clone();
+      EXPECT_EQ(law.first(newExpr), contains(matched, law.first)) << str << " " << law.second;
+    }
+  }
+}
+
+TEST(LawIndexTest, MeasureMatchesApply) {
+  std::vector<std::string> corpus = {
+      "p & T", "p | (q & r)", "(p | q) & (p | r)", "!(p & q)", "!!p",
+      "p | (p & q)", "(p -> q) & (q -> r)", "p <=> q", "!(p <=> q)",
+      "(p & q) -> ((r | s) -> !t)", "p ^ q"};
+
+  for (auto law : allLaws()) {
+    for (auto str : corpus) {
+      std::shared_ptr<Expression> expr;
+      parse(str, expr);
+
+      int size;
+      int depth;
+      bool measured = LawIndex::measure(law.first, expr, size, depth);
+      EXPECT_EQ(law.first(expr), measured) << str << " " << law.second;
+      if (measured) {
+        EXPECT_EQ(expr->getSize(), size) << str << " " << law.second;
+        EXPECT_EQ(expr->getDepth(), depth) << str << " " << law.second;
+      }
+    }
+  }
+
+  int size;
+  int depth;
+  std::shared_ptr<Expression> expr;
+  parse("p", expr);
+  EXPECT_FALSE(LawIndex::measure(alwaysApplies, expr, size, depth));
+}
+
+TEST(LawIndexTest, RepeatedVariables) {
+  LawIndex index;
+  index.insert(EquivLaws::idempotent);
+  index.insert(EquivLaws::distributiveReversed);
+  std::shared_ptr<Expression> expr;
+
+  parse("(p | q) & (p | q)", expr);
+  std::vector<EquivLaws::EquivLaw> expected = {EquivLaws::idempotent, EquivLaws::distributiveReversed};
+  EXPECT_EQ(expected, index.match(expr));
+
+  parse("(p | q) & (r | q)", expr);
+  EXPECT_TRUE(index.match(expr).empty());
+}
+
+TEST(LawIndexTest, InsertionOrder) {
+  LawIndex index;
+  index.insert(EquivLaws::implication2);
+  index.insert(EquivLaws::commutative);
+  index.insert(EquivLaws::implication2);
+  std::shared_ptr<Expression> expr;
+
+  parse("p | q", expr);
+  std::vector<EquivLaws::EquivLaw> expected = {EquivLaws::implication2, EquivLaws::commutative};
+  EXPECT_EQ(expected, index.match(expr));
+  EXPECT_EQ(2, index.size());
+
+  index.clear();
+  EXPECT_EQ(0, index.size());
+  EXPECT_TRUE(index.match(expr).empty());
+}
+
+TEST(LawIndexTest, UnindexedLaw) {
+  LawIndex index;
+  index.insert(alwaysApplies);
+  index.insert(EquivLaws::doubleNegation);
+  std::shared_ptr<Expression> expr;
+
+  parse("p ^ q", expr);
+  std::vector<EquivLaws::EquivLaw> expected = {alwaysApplies};
+  EXPECT_EQ(expected, index.match(expr));
+
+  parse("!!p", expr);
+  expected = {alwaysApplies, EquivLaws::doubleNegation};
+  EXPECT_EQ(expected, index.match(expr));
+}
@@ -0,0 +1,131 @@
+#include "../include/normalForm.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include <gtest/gtest.h>
+
+
+// checks that a law with the name turns one expression into the other at
+// some position, in either direction
+static bool follows(std::string from, std::string to, std::string lawName)
+{
+  std::vector<EquivLaws::EquivLaw> laws;
+  for (auto map : {&EquivLaws::laws, &EquivLaws::implications, &EquivLaws::bidirectionalImplications})
+    for (auto law : *map)
+      if (law.second == lawName)
+        laws.push_back(law.first);
+
+  for (int direction = 0; direction < 2; direction++)
+  {
+    std::shared_ptr<Expression> previous;
+    std::shared_ptr<Expression> current;
+    parse(direction ? to : from, previous);
+    parse(direction ? from : to, current);
+
+    std::vector<std::string> positions = {""};
+    for (size_t i = 0; i < positions.size(); i++)
+    {
+      std::shared_ptr<Expression> subexpression = getSubexpression(previous, positions[i]);
+      if (subexpression->hasLeft())
+        positions.push_back(positions[i] + "L");
+      if (subexpression->hasRight())
+        positions.push_back(positions[i] + "R");
+
+      for (auto law : laws)
+      {
+        std::shared_ptr<Expression> newExpr = previous->clone();
+        std::shared_ptr<Expression> newSubexpression = getSubexpression(newExpr, positions[i]);
+        if (!law(newSubexpression))
+          continue;
+        if (positions[i].empty())
+          newExpr = newSubexpression;
+        if (newExpr->compare(current))
+          return true;
+      }
+    }
+  }
+  return false;
+}
+
+static bool isValidSteps(const std::vector<std::vector<std::string>> &steps)
+{
+  for (size_t i = 1; i < steps.size(); i++)
+  {
+    if (!follows(steps[i - 1][0], steps[i][0], steps[i][1]))
+    {
+      ADD_FAILURE() << steps[i - 1][0] << " to " << steps[i][0] << " by " << steps[i][1];
+      return false;
+    }
+  }
+  return true;
+}
+
+static std::vector<std::vector<std::string>> normalizeString(std::string str, std::set<std::string> variables)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return normalize(expr, variables);
+}
+
+static std::string treeString(std::string str)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return expr->toStringTree();
+}
+
+TEST(NormalFormTest, Normalize) {
+  std::vector<std::vector<std::string>> steps = normalizeString("p | q", {"p", "q"});
+  EXPECT_EQ(treeString("p | q"), steps.front()[0]);
+  EXPECT_EQ("Given", steps.front()[1]);
+  EXPECT_EQ(treeString("(p & q) | ((p & !q) | (!p & q))"), steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+
+  steps = normalizeString("p & q", {"p", "q"});
+  EXPECT_EQ(1, steps.size());
+}
+
+TEST(NormalFormTest, EquivalentExpressions) {
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"p -> q", "!q -> !p"},
+      {"!(p | (!p & q))", "!p & !q"},
+      {"p <=> q", "(p -> q) & (q -> p)"},
+      {"(p -> q) & (p -> r)", "p -> (q & r)"},
+      {"!(p & (q | !r))", "(r & !q) | !p"},
+      {"p | (q & r) | (p & !q)", "(p | q) & (p | r)"},
+      {"!T | q", "q & (q | T)"}};
+
+  for (auto pair : pairs) {
+    std::set<std::string> variables = {"p", "q", "r"};
+    std::vector<std::vector<std::string>> lhsSteps = normalizeString(pair.first, variables);
+    std::vector<std::vector<std::string>> rhsSteps = normalizeString(pair.second, variables);
+    EXPECT_EQ(lhsSteps.back()[0], rhsSteps.back()[0]) << pair.first;
+    EXPECT_TRUE(isValidSteps(lhsSteps)) << pair.first;
+    EXPECT_TRUE(isValidSteps(rhsSteps)) << pair.second;
+  }
+}
+
+TEST(NormalFormTest, Constants) {
+  std::vector<std::vector<std::string>> steps = normalizeString("p & !p", {"p", "q"});
+  EXPECT_EQ("F", steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+
+  steps = normalizeString("!F", {"p", "q"});
+  EXPECT_EQ(normalizeString("p | !p", {"p", "q"}).back()[0], steps.back()[0]);
+  EXPECT_EQ(treeString("(p & q) | ((p & !q) | ((!p & q) | (!p & !q)))"), steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+}
+
+TEST(NormalFormTest, UnsupportedOperator) {
+  EXPECT_TRUE(normalizeString("p ^ q", {"p", "q"}).empty());
+  EXPECT_TRUE(normalizeString("p -> !(q ^ r)", {"p", "q", "r"}).empty());
+}
+
+TEST(NormalFormTest, TooManyVariables) {
+  std::vector<std::vector<std::string>> steps = normalizeString("p & q & r & s & t & !u", {"p", "q", "r", "s", "t", "u"});
+  EXPECT_EQ(treeString("p & (q & (r & (s & (t & !u))))"), steps.back()[0]);
+  EXPECT_TRUE(isValidSteps(steps));
+
+  // the variables of the expression count too
+  EXPECT_TRUE(normalizeString("p & q & r & s & t & !u", {"v"}).empty());
+  EXPECT_TRUE(normalizeString("p | q | r | s | t | u | v", {}).empty());
+}
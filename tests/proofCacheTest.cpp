@@ -0,0 +1,87 @@
+#include "../include/parser.h"
+#include "../include/proofCache.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+
+static std::string cachePath()
+{
+  return (std::filesystem::temp_directory_path() / "logixprProofCacheTest.bin").string();
+}
+
+static std::shared_ptr<Expression> parseString(std::string str)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return expr;
+}
+
+TEST(ProofCacheTest, Fingerprint) {
+  EXPECT_EQ(ProofCache::fingerprint(parseString("p & (q | r)")), ProofCache::fingerprint(parseString("(p)&((q|r))")));
+  EXPECT_NE(ProofCache::fingerprint(parseString("p & (q | r)")), ProofCache::fingerprint(parseString("(p & q) | r")));
+}
+
+TEST(ProofCacheTest, InsertAndFind) {
+  std::filesystem::remove(cachePath());
+  std::vector<std::vector<std::string>> steps = {
+      {"(p) -> (q)", "Given"},
+      {"(!(p)) | (q)", "Implication Equivalence"}};
+  std::vector<std::vector<std::string>> found;
+
+  ProofCache cache;
+  EXPECT_FALSE(cache.insert(parseString("p -> q"), parseString("!p | q"), steps));
+  ASSERT_TRUE(cache.open(cachePath()));
+  EXPECT_EQ(0, cache.size());
+  EXPECT_FALSE(cache.find(parseString("p -> q"), parseString("!p | q"), found));
+
+  EXPECT_TRUE(cache.insert(parseString("p -> q"), parseString("!p | q"), steps));
+  EXPECT_FALSE(cache.insert(parseString("p -> q"), parseString("!p | q"), steps));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_TRUE(cache.find(parseString("(p -> q)"), parseString("(!p) | q"), found));
+  EXPECT_EQ(steps, found);
+  EXPECT_FALSE(cache.find(parseString("!p | q"), parseString("p -> q"), found));
+
+  // the proofs survive reopening the file
+  cache.close();
+  EXPECT_FALSE(cache.find(parseString("p -> q"), parseString("!p | q"), found));
+  ProofCache reopened;
+  ASSERT_TRUE(reopened.open(cachePath()));
+  EXPECT_EQ(1, reopened.size());
+  found.clear();
+  EXPECT_TRUE(reopened.find(parseString("p -> q"), parseString("!p | q"), found));
+  EXPECT_EQ(steps, found);
+
+  EXPECT_TRUE(reopened.insert(parseString("p"), parseString("p & p"), {{"p", "Given"}, {"(p) & (p)", "Idempotent Law"}}));
+  EXPECT_EQ(2, reopened.size());
+  reopened.close();
+  std::filesystem::remove(cachePath());
+}
+
+TEST(ProofCacheTest, BadFiles) {
+  std::filesystem::remove(cachePath());
+  ProofCache cache;
+  ASSERT_TRUE(cache.open(cachePath()));
+  EXPECT_TRUE(cache.insert(parseString("p -> q"), parseString("!p | q"), {{"(p) -> (q)", "Given"}, {"(!(p)) | (q)", "Implication Equivalence"}}));
+  cache.close();
+
+  // a record cut short is dropped and the file is repaired
+  uintmax_t size = std::filesystem::file_size(cachePath());
+  {
+    std::ofstream file(cachePath(), std::ios::binary | std::ios::app);
+    file.write("\x40\x00\x00\x00garbage", 11);
+  }
+  ASSERT_TRUE(cache.open(cachePath()));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(size, std::filesystem::file_size(cachePath()));
+  cache.close();
+
+  // a file that is not a proof cache is left alone
+  {
+    std::ofstream file(cachePath(), std::ios::binary);
+    file << "MAX_NODES=15\n";
+  }
+  EXPECT_FALSE(cache.open(cachePath()));
+  EXPECT_FALSE(cache.insert(parseString("p"), parseString("p & p"), {{"p", "Given"}}));
+  std::filesystem::remove(cachePath());
+}
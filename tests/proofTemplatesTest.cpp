@@ -0,0 +1,53 @@
+#include "../include/parser.h"
+#include "../include/proofTemplates.h"
+#include <gtest/gtest.h>
+
+
+static std::shared_ptr<Expression> parseString(std::string str)
+{
+  std::shared_ptr<Expression> expr;
+  parse(str, expr);
+  return expr;
+}
+
+TEST(ProofTemplatesTest, Insert) {
+  ProofTemplates templates;
+  std::vector<std::vector<std::string>> steps = {
+      {"(p) -> (q)", "Given"},
+      {"(!(q)) -> (!(p))", "Contrapositive"}};
+
+  EXPECT_TRUE(templates.insert(parseString("p -> q"), parseString("!q -> !p"), steps));
+  EXPECT_FALSE(templates.insert(parseString("p -> q"), parseString("!q -> !p"), steps));
+  EXPECT_EQ(1, templates.size());
+
+  // too short, and a variable in neither expression
+  EXPECT_FALSE(templates.insert(parseString("p"), parseString("p"), {{"p", "Given"}}));
+  EXPECT_FALSE(templates.insert(parseString("p"), parseString("p & T"), {{"p", "Given"}, {"(p) & ((q) | (!(q)))", "Negation Law"}, {"(p) & (T)", "Negation Law"}}));
+  EXPECT_EQ(1, templates.size());
+
+  templates.clear();
+  EXPECT_EQ(0, templates.size());
+}
+
+TEST(ProofTemplatesTest, Instantiate) {
+  ProofTemplates templates;
+  std::vector<std::vector<std::string>> found;
+  templates.insert(parseString("p -> q"), parseString("!q -> !p"), {{"(p) -> (q)", "Given"}, {"(!(q)) -> (!(p))", "Contrapositive"}});
+  templates.insert(parseString("p & p"), parseString("p | p"), {{"(p) & (p)", "Given"}, {"p", "Idempotent Law"}, {"(p) | (p)", "Idempotent Law"}});
+
+  EXPECT_TRUE(templates.instantiate(parseString("(a & b) -> c"), parseString("!c -> !(a & b)"), found));
+  std::vector<std::vector<std::string>> expected = {
+      {parseString("(a & b) -> c")->toStringTree(), "Given"},
+      {parseString("!c -> !(a & b)")->toStringTree(), "Contrapositive"}};
+  EXPECT_EQ(expected, found);
+
+  // repeated variables must stand for the same subexpression
+  EXPECT_TRUE(templates.instantiate(parseString("(a -> b) & (a -> b)"), parseString("(a -> b) | (a -> b)"), found));
+  EXPECT_EQ(3, found.size());
+  EXPECT_EQ(parseString("a -> b")->toStringTree(), found[1][0]);
+  EXPECT_FALSE(templates.instantiate(parseString("(a -> b) & (b -> a)"), parseString("(a -> b) | (b -> a)"), found));
+
+  // the rhs must match too
+  EXPECT_FALSE(templates.instantiate(parseString("a -> b"), parseString("!a -> !b"), found));
+  EXPECT_FALSE(templates.instantiate(parseString("a | b"), parseString("b | a"), found));
+}
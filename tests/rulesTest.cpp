@@ -0,0 +1,177 @@
+#include "../include/rules.h"
+#include "../include/parser.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+
+static const std::vector<std::pair<EquivLaws::EquivLaw, EquivLaws::EquivLaw>> mirroredLaws = {
+    {EquivLaws::identity, rules::Identity::apply},
+    {EquivLaws::domination, rules::Domination::apply},
+    {EquivLaws::idempotent, rules::Idempotent::apply},
+    {EquivLaws::doubleNegation, rules::DoubleNegation::apply},
+    {EquivLaws::commutative, rules::Commutative::apply},
+    {EquivLaws::associative, rules::Associative::apply},
+    {EquivLaws::associativeReversed, rules::AssociativeReversed::apply},
+    {EquivLaws::distributive, rules::Distributive::apply},
+    {EquivLaws::distributiveReversed, rules::DistributiveReversed::apply},
+    {EquivLaws::deMorgan, rules::DeMorgan::apply},
+    {EquivLaws::deMorganReversed, rules::DeMorganReversed::apply},
+    {EquivLaws::absorption, rules::Absorption::apply},
+    {EquivLaws::negation, rules::Negation::apply},
+    {EquivLaws::implication0, rules::Implication0::apply},
+    {EquivLaws::implication0Reversed, rules::Implication0Reversed::apply},
+    {EquivLaws::implication1, rules::Implication1::apply},
+    {EquivLaws::implication1Reversed, rules::Implication1Reversed::apply},
+    {EquivLaws::implication2, rules::Implication2::apply},
+    {EquivLaws::implication2Reversed, rules::Implication2Reversed::apply},
+    {EquivLaws::implication3, rules::Implication3::apply},
+    {EquivLaws::implication3Reversed, rules::Implication3Reversed::apply},
+    {EquivLaws::implication4, rules::Implication4::apply},
+    {EquivLaws::implication4Reversed, rules::Implication4Reversed::apply},
+    {EquivLaws::implication5, rules::Implication5::apply},
+    {EquivLaws::implication5Reversed, rules::Implication5Reversed::apply},
+    {EquivLaws::implication6, rules::Implication6::apply},
+    {EquivLaws::implication6Reversed, rules::Implication6Reversed::apply},
+    {EquivLaws::implication7, rules::Implication7::apply},
+    {EquivLaws::implication7Reversed, rules::Implication7Reversed::apply},
+    {EquivLaws::implication8, rules::Implication8::apply},
+    {EquivLaws::implication8Reversed, rules::Implication8Reversed::apply},
+    {EquivLaws::bidirectionalImplication0, rules::BidirectionalImplication0::apply},
+    {EquivLaws::bidirectionalImplication0Reversed, rules::BidirectionalImplication0Reversed::apply},
+    {EquivLaws::bidirectionalImplication1, rules::BidirectionalImplication1::apply},
+    {EquivLaws::bidirectionalImplication2, rules::BidirectionalImplication2::apply},
+    {EquivLaws::bidirectionalImplication2Reversed, rules::BidirectionalImplication2Reversed::apply},
+    {EquivLaws::bidirectionalImplication3, rules::BidirectionalImplication3::apply},
+    {EquivLaws::bidirectionalImplication3Reversed, rules::BidirectionalImplication3Reversed::apply},
+    {EquivLaws::bidirectionalImplication4, rules::BidirectionalImplication4::apply},
+    {EquivLaws::bidirectionalImplication4Reversed, rules::BidirectionalImplication4Reversed::apply},
+};
+
+static const std::vector<std::string> corpus = {
+    "p", "T", "!p", "!!p", "p & T", "p | F", "p & F", "p | T", "p & p",
+    "p | p", "p & q", "p | q", "(p & q) & r", "(p | q) | r", "p & (q & r)",
+    "p | (q | r)", "p & (q | r)", "p | (q & r)", "(p | q) & (p | r)",
+    "(p & q) | (p & r)", "(p | q) & (r | s)", "!(p | q)", "!(p & q)",
+    "!p & !q", "!p | !q", "p | (p & q)", "p & (p | q)", "q | (p & q)",
+    "p | !p", "p & !p", "p & !q", "p -> q", "!p | q", "!q -> !p", "!p -> q",
+    "!(p -> !q)", "!(p -> q)", "(p -> q) & (p -> r)", "p -> (q & r)",
+    "(p -> q) & (q -> r)", "(p | q) -> r", "(p -> q) | (p -> r)",
+    "p -> (q | r)", "(p -> q) | (q -> r)", "(p & q) -> r", "p <=> q",
+    "(p -> q) & (q -> p)", "!p <=> !q", "(p & q) | (!p & !q)", "!(p <=> q)",
+    "p <=> !q", "p ^ q", "(p ^ q) & T", "!(p ^ q)", "(p <=> q) -> (r <=> s)",
+    "((p -> q) -> (r -> s)) & ((r -> s) -> (t -> u))"};
+
+TEST(RulesTest, MirrorsEquivLaws) {
+  for (auto laws : mirroredLaws) {
+    for (auto str : corpus) {
+      std::shared_ptr<Expression> expected;
+      std::shared_ptr<Expression> actual;
+      parse(str, expected);
+      parse(str, actual);
+
+      bool expectedApplied = laws.first(expected);
+      bool actualApplied = laws.second(actual);
+
+      EXPECT_EQ(expectedApplied, actualApplied) << str;
+      EXPECT_TRUE(expected->compare(actual)) << str;
+    }
+  }
+}
+
+TEST(RulesTest, RuleKeepsParent) {
+  std::shared_ptr<Expression> expr;
+  std::shared_ptr<Expression> expected;
+
+  parse("r | (p & T)", expr);
+  std::shared_ptr<Expression> right = expr->getRight();
+  EXPECT_TRUE(rules::Identity::apply(right));
+  EXPECT_EQ(expr, right->getParent());
+
+  parse("r | p", expected);
+  EXPECT_TRUE(expr->compare(expected));
+}
+
+TEST(RulesTest, RepeatedVariables) {
+  std::shared_ptr<Expression> expr;
+
+  parse("(p & q) | (p & q)", expr);
+  EXPECT_TRUE(rules::Idempotent::matches(expr));
+
+  parse("(p & q) | (q & p)", expr);
+  EXPECT_FALSE(rules::Idempotent::matches(expr));
+
+  std::shared_ptr<Expression> shared;
+  parse("p", shared);
+  expr = std::make_shared<Expression>(AND);
+  expr->setLeft(shared, expr);
+  expr->setRight(shared, expr);
+  EXPECT_TRUE(rules::Idempotent::matches(expr));
+}
+
+TEST(RulesTest, Patterns) {
+  typedef rules::Rule<rules::And<rules::P, rules::Or<rules::Q, rules::R>>,
+                      rules::Or<rules::And<rules::P, rules::Q>, rules::And<rules::P, rules::R>>>
+      distributive;
+  std::shared_ptr<Expression> expected;
+
+  parse("p & (q | r)", expected);
+  EXPECT_TRUE(distributive::lhs()->compare(expected));
+
+  parse("(p & q) | (p & r)", expected);
+  EXPECT_TRUE(distributive::rhs()->compare(expected));
+
+  typedef rules::Rule<rules::Or<rules::P, rules::True>, rules::True> domination;
+  parse("p | T", expected);
+  EXPECT_TRUE(domination::lhs()->compare(expected));
+}
+
+TEST(RulesTest, LawSetForEachMatch) {
+  std::shared_ptr<Expression> expr;
+  parse("p & (q | r)", expr);
+
+  std::vector<std::string> applied;
+  rules::Laws::forEachMatch(expr, [&](auto law) {
+    std::shared_ptr<Expression> newExpr = expr->clone();
+    EXPECT_TRUE(decltype(law)::apply(newExpr));
+    applied.push_back(newExpr->toString());
+  });
+
+  std::vector<std::string> expected = {"((q) | (r)) & (p)", "((p) & (q)) | ((p) & (r))"};
+  EXPECT_EQ(expected, applied);
+
+  applied.clear();
+  parse("p ^ q", expr);
+  rules::Laws::forEachMatch(expr, [&](auto) { applied.push_back(""); });
+  EXPECT_TRUE(applied.empty());
+}
+
+static bool neverApplies([[maybe_unused]] std::shared_ptr<Expression> &expression)
+{
+  return false;
+}
+
+TEST(RulesTest, ApplyByKey) {
+  for (auto laws : mirroredLaws) {
+    for (auto str : corpus) {
+      std::shared_ptr<Expression> expected;
+      std::shared_ptr<Expression> actual;
+      parse(str, expected);
+      parse(str, actual);
+
+      bool expectedApplied = laws.first(expected);
+      bool actualApplied = !expectedApplied;
+      ASSERT_TRUE(rules::apply(laws.first, actual, actualApplied)) << str;
+
+      EXPECT_EQ(expectedApplied, actualApplied) << str;
+      EXPECT_TRUE(expected->compare(actual)) << str;
+    }
+  }
+
+  // laws without rules are left to the caller
+  std::shared_ptr<Expression> expr;
+  parse("p & T", expr);
+  bool applied = true;
+  EXPECT_FALSE(rules::apply(neverApplies, expr, applied));
+  EXPECT_TRUE(applied);
+  EXPECT_EQ("(p) & (T)", expr->toString());
+}
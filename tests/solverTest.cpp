@@ -0,0 +1,794 @@
+#include "../include/solver.h"
+#include "../include/parser.h"
+#include <gtest/gtest.h>
+
+
+// checks that every step follows from the previous one by a single law
+static bool isValidProof(const std::vector<std::vector<std::string>> &steps, std::string lhs, std::string rhs)
+{
+  std::shared_ptr<Expression> expected;
+  std::shared_ptr<Expression> actual;
+
+  parse(lhs, expected);
+  parse(steps.front()[0], actual);
+  if (!expected->compare(actual))
+    return false;
+
+  parse(rhs, expected);
+  parse(steps.back()[0], actual);
+  if (!expected->compare(actual))
+    return false;
+
+  for (size_t i = 1; i < steps.size(); i++)
+  {
+    std::shared_ptr<Expression> previous;
+    std::shared_ptr<Expression> current;
+    parse(steps[i - 1][0], previous);
+    parse(steps[i][0], current);
+
+    std::vector<Match> matches;
+    findMatches(previous, "", matches);
+
+    bool valid = false;
+    for (auto match : matches)
+    {
+      if (equivalences[match.law] != steps[i][1])
+        continue;
+
+      std::shared_ptr<Expression> newExpr = previous->clone();
+      std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, match.position);
+      match.law(subexpression);
+      if (match.position.empty())
+        newExpr = subexpression;
+
+      if (newExpr->compare(current))
+        valid = true;
+    }
+    if (!valid)
+      return false;
+  }
+  return true;
+}
+
+static std::vector<std::vector<std::string>> prove(std::string lhs, std::string rhs)
+{
+  std::shared_ptr<Expression> lhsTree;
+  std::shared_ptr<Expression> rhsTree;
+  parse(lhs, lhsTree);
+  parse(rhs, rhsTree);
+
+  preprocess(lhsTree, rhsTree);
+  return proveEquivalence(lhsTree, rhsTree);
+}
+
+TEST(SolverTest, GetSubexpression) {
+  std::shared_ptr<Expression> expr;
+  parse("(p & !q) | r", expr);
+
+  EXPECT_EQ(expr, getSubexpression(expr, ""));
+  EXPECT_EQ("r", getSubexpression(expr, "R")->getValue());
+  EXPECT_EQ("q", getSubexpression(expr, "LRL")->getValue());
+}
+
+TEST(SolverTest, FindMatches) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("!!p & T", lhs);
+  parse("p", rhs);
+  preprocess(lhs, rhs);
+
+  std::vector<Match> matches;
+  findMatches(lhs, "", matches);
+
+  std::vector<std::string> positions;
+  for (auto match : matches)
+    positions.push_back(match.position);
+
+  EXPECT_TRUE(std::is_sorted(positions.begin(), positions.end()));
+  EXPECT_NE(positions.end(), std::find(positions.begin(), positions.end(), "L"));
+  EXPECT_EQ(positions.end(), std::find(positions.begin(), positions.end(), "LL"));
+  EXPECT_EQ(positions.end(), std::find(positions.begin(), positions.end(), "R"));
+}
+
+TEST(SolverTest, UpdateMatchesEqualsFindMatches) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("((p | q) & (p | q)) | !(r & (s -> !t))", lhs);
+  parse("p", rhs);
+  preprocess(lhs, rhs);
+
+  std::vector<Match> matches;
+  findMatches(lhs, "", matches);
+
+  for (auto match : matches)
+  {
+    std::shared_ptr<Expression> newExpr = lhs->clone();
+    std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, match.position);
+    EXPECT_TRUE(match.law(subexpression));
+    if (match.position.empty())
+      newExpr = subexpression;
+
+    std::vector<Match> expected;
+    findMatches(newExpr, "", expected);
+    std::vector<Match> actual = updateMatches(matches, newExpr, match.position);
+
+    ASSERT_EQ(expected.size(), actual.size()) << match.position;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+      EXPECT_EQ(expected[i].position, actual[i].position);
+      EXPECT_EQ(expected[i].law, actual[i].law);
+    }
+  }
+}
+
+TEST(SolverTest, ProveSame) {
+  std::vector<std::vector<std::string>> steps = prove("p & q", "p & q");
+  EXPECT_EQ(1, steps.size());
+  EXPECT_EQ("Given", steps[0][1]);
+}
+
+TEST(SolverTest, ProveSimple) {
+  std::vector<std::vector<std::string>> steps = prove("p -> q", "!q -> !p");
+  EXPECT_EQ(2, steps.size());
+  EXPECT_TRUE(isValidProof(steps, "p -> q", "!q -> !p"));
+}
+
+TEST(SolverTest, ProveComplex) {
+  std::vector<std::vector<std::string>> steps = prove("!(p | (!p & q))", "!p & !q");
+  EXPECT_EQ(6, steps.size());
+  EXPECT_TRUE(isValidProof(steps, "!(p | (!p & q))", "!p & !q"));
+
+  steps = prove("p <=> q", "(p & q) | (!p & !q)");
+  EXPECT_TRUE(isValidProof(steps, "p <=> q", "(p & q) | (!p & !q)"));
+}
+
+TEST(SolverTest, SkipsInverseOfLastStep) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("(q & p) | r", lhs);
+  parse("s", rhs);
+  preprocess(lhs, rhs);
+
+  SearchState state = {lhs, {}, {"L", EquivLaws::commutative}};
+  findMatches(lhs, "", state.matches);
+
+  bool found = false;
+  std::queue<SearchState> queue;
+  std::unordered_map<std::string, std::pair<std::string, std::string>> visited;
+  SearchMemory memory;
+  generateNextSteps(state, rhs, found, queue, visited, memory);
+
+  std::shared_ptr<Expression> parent;
+  std::shared_ptr<Expression> sibling;
+  parse("(p & q) | r", parent);
+  parse("r | (q & p)", sibling);
+  EXPECT_EQ(visited.end(), visited.find(parent->toString()));
+  EXPECT_NE(visited.end(), visited.find(sibling->toString()));
+
+  state.producedBy = {"", EquivLaws::commutative};
+  generateNextSteps(state, rhs, found, queue, visited, memory);
+  EXPECT_NE(visited.end(), visited.find(parent->toString()));
+}
+
+TEST(SolverTest, MeasureStep) {
+  std::shared_ptr<Expression> expr;
+  parse("r | ((p | q) & (p | r))", expr);
+  preprocess(expr, expr);
+
+  std::vector<Match> matches;
+  findMatches(expr, "", matches);
+  for (auto match : matches) {
+    int size;
+    int depth;
+    EXPECT_TRUE(measureStep(expr, match.position, match.law, size, depth));
+
+    std::shared_ptr<Expression> newExpr = expr->clone();
+    std::shared_ptr<Expression> subexpression = getSubexpression(newExpr, match.position);
+    EXPECT_TRUE(match.law(subexpression));
+    if (match.position.empty())
+      newExpr = subexpression;
+    EXPECT_EQ(newExpr->getSize(), size) << match.position << " " << equivalences[match.law];
+    EXPECT_EQ(newExpr->getDepth(), depth) << match.position << " " << equivalences[match.law];
+  }
+}
+
+TEST(SolverTest, BoundsRejectLargeExpressions) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("p -> q", lhs);
+  parse("!q -> !p", rhs);
+  preprocess(lhs, rhs);
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  int maxNodes = MAX_NODES;
+  MAX_NODES = 3;
+  EXPECT_EQ(ProofStatus::NotFound, breadthFirstSearch(lhs, rhs, deadline, cancelled).status);
+  MAX_NODES = maxNodes;
+
+  int maxDepth = MAX_DEPTH;
+  MAX_DEPTH = 2;
+  EXPECT_EQ(ProofStatus::NotFound, breadthFirstSearch(lhs, rhs, deadline, cancelled).status);
+
+  // the normal form search takes over and is not bounded
+  std::vector<std::vector<std::string>> steps = prove("p -> q", "!q -> !p");
+  EXPECT_GT(steps.size(), 2);
+  EXPECT_EQ("Implication Equivalence", steps[1][1]);
+  MAX_DEPTH = maxDepth;
+
+  steps = prove("p -> q", "!q -> !p");
+  EXPECT_TRUE(isValidProof(steps, "p -> q", "!q -> !p"));
+}
+
+TEST(SolverTest, CompactStates) {
+  std::shared_ptr<Expression> expr;
+  parse("(p | !q) & (q -> (r <=> p))", expr);
+  preprocess(expr, expr);
+
+  SearchState state = {expr, {}, {"RL", EquivLaws::commutative}};
+  findMatches(expr, "", state.matches);
+
+  SearchState compacted = compactState(state);
+  EXPECT_EQ(nullptr, compacted.expr);
+  EXPECT_LT(stateMemory(compacted), stateMemory(state));
+
+  expandState(compacted);
+  EXPECT_TRUE(compacted.expr->compareTree(expr));
+  EXPECT_EQ(expr->toStringTree(), compacted.expr->toStringTree());
+  EXPECT_EQ("RL", compacted.producedBy.position);
+  ASSERT_EQ(state.matches.size(), compacted.matches.size());
+  for (size_t i = 0; i < state.matches.size(); i++) {
+    EXPECT_EQ(state.matches[i].position, compacted.matches[i].position);
+    EXPECT_EQ(state.matches[i].law, compacted.matches[i].law);
+  }
+}
+
+TEST(SolverTest, MemoryBudget) {
+  int maxMemory = MAX_MEMORY_MB;
+  MAX_MEMORY_MB = 1;
+  // needs about 1.5MB without storing states compactly
+  std::vector<std::vector<std::string>> steps = prove("(p -> q) & (p -> r)", "!(p & (!q | !r))");
+  EXPECT_EQ(6, steps.size());
+  EXPECT_TRUE(isValidProof(steps, "(p -> q) & (p -> r)", "!(p & (!q | !r))"));
+
+  // the iterative deepening search takes over once the memory runs out
+  int maxProofLength = MAX_PROOF_LENGTH;
+  MAX_PROOF_LENGTH = 3;
+  steps = prove("(p -> q) & (q -> r) & (r -> s)", "(s -> p) & (p -> q)");
+  EXPECT_EQ("Couldn't find a solution :(", steps.back()[1]);
+  MAX_PROOF_LENGTH = maxProofLength;
+  MAX_MEMORY_MB = maxMemory;
+}
+
+TEST(SolverTest, Deadline) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("p -> q", lhs);
+  parse("!q -> !p", rhs);
+  preprocess(lhs, rhs);
+  std::atomic<bool> cancelled(false);
+
+  ProofResult result = proveEquivalence(lhs, rhs, std::chrono::steady_clock::now(), cancelled);
+  EXPECT_EQ(ProofStatus::TimedOut, result.status);
+  EXPECT_TRUE(result.steps.empty());
+  EXPECT_EQ(0, result.stats.expanded);
+
+  // not equivalent, so only the deadline stops the search
+  parse("(p -> q) & (q -> r) & (r -> s)", lhs);
+  parse("(s -> p) & (p -> q)", rhs);
+  preprocess(lhs, rhs);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+  result = proveEquivalence(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::TimedOut, result.status);
+  EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+  EXPECT_GT(result.stats.expanded, 0);
+  EXPECT_GE(result.stats.generated, result.stats.expanded);
+  EXPECT_GT(result.stats.peakMemory, 0);
+  EXPECT_GT(result.stats.seconds, 0);
+}
+
+TEST(SolverTest, Cancellation) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("p -> q", lhs);
+  parse("!q -> !p", rhs);
+  preprocess(lhs, rhs);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  std::atomic<bool> cancelled(true);
+  ProofResult result = proveEquivalence(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Cancelled, result.status);
+
+  cancelled = false;
+  result = proveEquivalence(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(2, result.steps.size());
+  EXPECT_GT(result.stats.expanded, 0);
+}
+
+TEST(SolverTest, IterativeDeepening) {
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"p -> q", "!q -> !p"}, {"!(p | (!p & q))", "!p & !q"}, {"(p -> q) & (p -> r)", "!(p & (!q | !r))"}};
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  ProofResult breadthFirst;
+  ProofResult iterativeDeepening;
+
+  for (auto pair : pairs) {
+    std::shared_ptr<Expression> lhs;
+    std::shared_ptr<Expression> rhs;
+    parse(pair.first, lhs);
+    parse(pair.second, rhs);
+    preprocess(lhs, rhs);
+
+    breadthFirst = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+    iterativeDeepening = iterativeDeepeningSearch(lhs, rhs, deadline, cancelled);
+    EXPECT_EQ(ProofStatus::Proved, iterativeDeepening.status) << pair.first;
+    EXPECT_EQ(breadthFirst.steps.size(), iterativeDeepening.steps.size()) << pair.first;
+    EXPECT_TRUE(isValidProof(iterativeDeepening.steps, pair.first, pair.second)) << pair.first;
+  }
+
+  // only the longest proof needs enough states for the queue to outgrow the path
+  EXPECT_LT(iterativeDeepening.stats.peakMemory, breadthFirst.stats.peakMemory);
+
+  SEARCH_MODE = SearchMode::IterativeDeepening;
+  std::vector<std::vector<std::string>> steps = prove("p -> q", "!q -> !p");
+  EXPECT_EQ(2, steps.size());
+  SEARCH_MODE = SearchMode::BreadthFirst;
+}
+
+TEST(SolverTest, TreeDistance) {
+  std::shared_ptr<Expression> a;
+  std::shared_ptr<Expression> b;
+
+  parse("p & q", a);
+  parse("q & p", b);
+  EXPECT_EQ(0, treeDistance(a, b));
+
+  parse("p | q", b);
+  EXPECT_EQ(1, treeDistance(a, b));
+
+  parse("!(p & q)", b);
+  EXPECT_EQ(5, treeDistance(a, b));
+  EXPECT_EQ(3, treeDistance(a, nullptr));
+}
+
+TEST(SolverTest, Beam) {
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"p -> q", "!q -> !p"}, {"!(p | (!p & q))", "!p & !q"}, {"(p -> q) & (p -> r)", "!(p & (!q | !r))"}};
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  for (auto pair : pairs) {
+    std::shared_ptr<Expression> lhs;
+    std::shared_ptr<Expression> rhs;
+    parse(pair.first, lhs);
+    parse(pair.second, rhs);
+    preprocess(lhs, rhs);
+
+    ProofResult result = beamSearch(lhs, rhs, deadline, cancelled);
+    EXPECT_EQ(ProofStatus::Proved, result.status) << pair.first;
+    EXPECT_TRUE(isValidProof(result.steps, pair.first, pair.second)) << pair.first;
+    EXPECT_LE(result.stats.expanded, BEAM_WIDTH * MAX_PROOF_LENGTH) << pair.first;
+  }
+
+  SEARCH_MODE = SearchMode::Beam;
+  std::vector<std::vector<std::string>> steps = prove("p -> q", "!q -> !p");
+  EXPECT_TRUE(isValidProof(steps, "p -> q", "!q -> !p"));
+  SEARCH_MODE = SearchMode::BreadthFirst;
+}
+
+static int proofCost(const std::vector<std::vector<std::string>> &steps)
+{
+  int cost = 0;
+  for (size_t i = 1; i < steps.size(); i++)
+    cost += lawCost(steps[i][1]);
+  return cost;
+}
+
+TEST(SolverTest, UniformCost) {
+  std::vector<std::pair<std::string, std::string>> pairs = {
+      {"p -> q", "!q -> !p"}, {"!(p | (!p & q))", "!p & !q"}, {"p & (q | r)", "(r & p) | (q & p)"}};
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  for (int weighted = 0; weighted < 2; weighted++) {
+    if (weighted)
+      LAW_COSTS = {{"Commutative Law", 1}, {"Distributive Law", 30}};
+
+    for (auto pair : pairs) {
+      std::shared_ptr<Expression> lhs;
+      std::shared_ptr<Expression> rhs;
+      parse(pair.first, lhs);
+      parse(pair.second, rhs);
+      preprocess(lhs, rhs);
+
+      ProofResult breadthFirst = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+      ProofResult uniformCost = uniformCostSearch(lhs, rhs, deadline, cancelled);
+      EXPECT_EQ(ProofStatus::Proved, uniformCost.status) << pair.first;
+      EXPECT_TRUE(isValidProof(uniformCost.steps, pair.first, pair.second)) << pair.first;
+      EXPECT_LE(proofCost(uniformCost.steps), proofCost(breadthFirst.steps)) << pair.first;
+      if (!weighted)
+      {
+        EXPECT_EQ(breadthFirst.steps.size(), uniformCost.steps.size()) << pair.first;
+      }
+    }
+  }
+  LAW_COSTS.clear();
+}
+
+TEST(SolverTest, NormalForm) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  parse("(p -> q) & (p -> r)", lhs);
+  parse("!(p & (!q | !r))", rhs);
+  preprocess(lhs, rhs);
+  ProofResult result = normalFormSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(lhs->toStringTree(), result.steps.front()[0]);
+  EXPECT_EQ(rhs->toStringTree(), result.steps.back()[0]);
+
+  // no expression is repeated
+  std::set<std::string> expressions;
+  for (auto step : result.steps)
+    EXPECT_TRUE(expressions.insert(step[0]).second) << step[0];
+
+  parse("p -> q", rhs);
+  preprocess(lhs, rhs);
+  EXPECT_EQ(ProofStatus::NotFound, normalFormSearch(lhs, rhs, deadline, cancelled).status);
+}
+
+TEST(SolverTest, EGraph) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  parse("(p -> q) & (p -> r)", lhs);
+  parse("!(p & (!q | !r))", rhs);
+  preprocess(lhs, rhs);
+  ProofResult result = eGraphSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(lhs->toStringTree(), result.steps.front()[0]);
+  EXPECT_EQ(rhs->toStringTree(), result.steps.back()[0]);
+  EXPECT_GT(result.stats.generated, 0);
+
+  SEARCH_MODE = SearchMode::EGraph;
+  EXPECT_EQ(rhs->toStringTree(), proveEquivalence(lhs, rhs).back()[0]);
+  SEARCH_MODE = SearchMode::BreadthFirst;
+
+  int maxEGraphNodes = MAX_EGRAPH_NODES;
+  MAX_EGRAPH_NODES = 500;
+  parse("p -> q", rhs);
+  preprocess(lhs, rhs);
+  EXPECT_EQ(ProofStatus::NotFound, eGraphSearch(lhs, rhs, deadline, cancelled).status);
+  MAX_EGRAPH_NODES = maxEGraphNodes;
+
+  cancelled = true;
+  EXPECT_EQ(ProofStatus::Cancelled, eGraphSearch(lhs, rhs, deadline, cancelled).status);
+}
+
+TEST(SolverTest, ShortenProof) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  std::vector<std::vector<std::string>> steps = {
+      {"p -> (q -> r)", "Given"},
+      {"p -> (!q | r)", "Implication Equivalence"},
+      {"!p | (!q | r)", "Implication Equivalence"},
+      {"(!p | !q) | r", "Associative Law"},
+      {"!(p & q) | r", "De Morgan's Law"},
+      {"!(q & p) | r", "Commutative Law"},
+      {"!(p & q) | r", "Commutative Law"},
+      {"(p & q) -> r", "Implication Equivalence"}};
+  for (auto &step : steps) {
+    parse(step[0], lhs);
+    step[0] = lhs->toStringTree();
+  }
+  parse(steps.front()[0], lhs);
+  parse(steps.back()[0], rhs);
+  preprocess(lhs, rhs);
+
+  ProofResult result = shortenProof({ProofStatus::Proved, steps, {}}, 4, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(steps.front()[0], result.steps.front()[0]);
+  EXPECT_EQ(steps.back()[0], result.steps.back()[0]);
+  EXPECT_EQ(breadthFirstSearch(lhs, rhs, deadline, cancelled).steps.size(), result.steps.size());
+  EXPECT_GT(result.stats.expanded, 0);
+
+  // a window of 2 steps only cuts out the loop
+  EXPECT_EQ(6, shortenProof({ProofStatus::Proved, steps, {}}, 1, deadline, cancelled).steps.size());
+
+  EXPECT_TRUE(shortenProof({ProofStatus::NotFound, {}, {}}, 4, deadline, cancelled).steps.empty());
+
+  cancelled = true;
+  EXPECT_EQ(6, shortenProof({ProofStatus::Proved, steps, {}}, 4, deadline, cancelled).steps.size());
+}
+
+TEST(SolverTest, MinimizeParentheses) {
+  std::vector<std::vector<std::string>> steps = {
+      {"((p & q) & r)", "Given"},
+      {"(p & (q & r))", "Associative Law"},
+      {"((q & r) & p)", "Commutative Law"}};
+  std::vector<std::vector<std::string>> expected = {
+      {"p & q & r", "Given"},
+      {"q & r & p", "Commutative Law"}};
+  EXPECT_EQ(expected, minimizeParentheses(steps));
+}
+
+TEST(SolverTest, Decompose) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  parse("p & q", lhs);
+  parse("q & p", rhs);
+  EXPECT_FALSE(isDecomposable(lhs, rhs));
+  parse("p | q", rhs);
+  EXPECT_FALSE(isDecomposable(lhs, rhs));
+  parse("!(p -> q)", lhs);
+  parse("!(!p | q)", rhs);
+  EXPECT_TRUE(isDecomposable(lhs, rhs));
+
+  parse("(p -> q) & !(!r & !s)", lhs);
+  parse("(!p | q) & (s | r)", rhs);
+  EXPECT_FALSE(isDecomposable(lhs->getRight(), rhs->getRight()));
+  EXPECT_TRUE(isDecomposable(lhs, rhs));
+  preprocess(lhs, rhs);
+  ProofResult result = decomposedSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(lhs->toStringTree(), result.steps.front()[0]);
+  EXPECT_EQ(rhs->toStringTree(), result.steps.back()[0]);
+  EXPECT_EQ(breadthFirstSearch(lhs, rhs, deadline, cancelled).steps.size(), result.steps.size());
+
+  // the left child is rewritten first
+  std::shared_ptr<Expression> step;
+  parse(result.steps[1][0], step);
+  EXPECT_EQ(lhs->getRight()->clone()->toStringTree(), step->getRight()->clone()->toStringTree());
+
+  // a child that is already equal is kept as it is
+  parse("p & !(!r & !s)", lhs);
+  parse("p & (s | r)", rhs);
+  result = decomposedSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(lhs->toStringTree(), result.steps.front()[0]);
+  EXPECT_EQ(rhs->toStringTree(), result.steps.back()[0]);
+
+  cancelled = true;
+  result = decomposedSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Cancelled, result.status);
+  EXPECT_TRUE(result.steps.empty());
+}
+
+TEST(SolverTest, DecomposeFallBack) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  int maxNodes = MAX_NODES;
+  int maxDepth = MAX_DEPTH;
+  MAX_NODES = 9;
+  MAX_DEPTH = 4;
+
+  // no law rewrites ^, so the children cannot be proved on their own, but
+  // the whole problem is a single step
+  parse("(p ^ q) & !(p <=> q)", lhs);
+  parse("!(p <=> q) & (p ^ q)", rhs);
+  ASSERT_TRUE(isDecomposable(lhs, rhs));
+  preprocess(lhs, rhs);
+  EXPECT_NE(ProofStatus::Proved, decomposedSearch(lhs, rhs, deadline, cancelled).status);
+  ProofResult result = proveEquivalence(lhs, rhs, deadline, cancelled);
+  ASSERT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(2, result.steps.size());
+  EXPECT_EQ("Commutative Law", result.steps[1][1]);
+  MAX_NODES = maxNodes;
+  MAX_DEPTH = maxDepth;
+}
+
+TEST(SolverTest, DecomposeThreads) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+  int threads = MAX_DECOMPOSITION_THREADS;
+
+  // without threads to spare every pair is proved on the calling thread
+  parse("(p -> q) & !(!r & !s)", lhs);
+  parse("(!p | q) & (s | r)", rhs);
+  preprocess(lhs, rhs);
+  MAX_DECOMPOSITION_THREADS = 0;
+  ProofResult inlined = decomposedSearch(lhs, rhs, deadline, cancelled);
+  MAX_DECOMPOSITION_THREADS = threads;
+  ProofResult parallel = decomposedSearch(lhs, rhs, deadline, cancelled);
+  ASSERT_EQ(ProofStatus::Proved, inlined.status);
+  EXPECT_EQ(parallel.steps, inlined.steps);
+}
+
+TEST(SolverTest, FreezeAligned) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  parse("(p & (q | r)) | !(!s)", lhs);
+  parse("(p & (q | r)) | (!s & F)", rhs);
+  EXPECT_EQ(std::vector<std::string>({"L"}), findFrozen(lhs, rhs));
+  parse("(p & (r | q)) | !(!s)", rhs);
+  EXPECT_EQ(std::vector<std::string>({"LL", "R"}), findFrozen(lhs, rhs));
+  parse("(p & (q | r)) & !(!s)", rhs);
+  EXPECT_TRUE(findFrozen(lhs, rhs).empty());
+
+  // only the right side differs, so the left side is never rewritten
+  parse("(p & (q | r)) | s", rhs);
+  preprocess(lhs, rhs);
+  ProofResult full = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+  FREEZE_ALIGNED = true;
+  ProofResult frozen = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(ProofStatus::Proved, frozen.status);
+  EXPECT_EQ(full.steps, frozen.steps);
+  EXPECT_LT(frozen.stats.generated, full.stats.generated);
+
+  // the frozen search finds nothing, so it starts over with everything
+  parse("(q & p) & p", lhs);
+  parse("(q & p) & q", rhs);
+  preprocess(lhs, rhs);
+  frozen = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+  FREEZE_ALIGNED = false;
+  full = breadthFirstSearch(lhs, rhs, deadline, cancelled);
+  EXPECT_EQ(full.status, frozen.status);
+  EXPECT_GT(frozen.stats.expanded, full.stats.expanded);
+}
+
+TEST(SolverTest, Renaming) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("(z -> x) & x", lhs);
+  parse("x & (!z | y)", rhs);
+
+  std::unordered_map<std::string, std::string> renaming = getRenaming(lhs, rhs);
+  std::unordered_map<std::string, std::string> expected = {{"z", "a"}, {"x", "b"}, {"y", "c"}};
+  EXPECT_EQ(expected, renaming);
+  std::unordered_map<std::string, std::string> inverse = {{"a", "z"}, {"b", "x"}, {"c", "y"}};
+  EXPECT_EQ(inverse, invertRenaming(renaming));
+
+  std::shared_ptr<Expression> renamed = renameVariables(lhs, renaming);
+  std::shared_ptr<Expression> expectedExpr;
+  parse("(a -> b) & b", expectedExpr);
+  EXPECT_TRUE(renamed->compare(expectedExpr));
+  EXPECT_EQ("((z) -> (x)) & (x)", lhs->toStringTree());
+
+  std::vector<std::vector<std::string>> steps = {{"((a) -> (b)) & (T)", "Given"}, {"", "Given"}};
+  std::vector<std::vector<std::string>> renamedSteps = {{"((z) -> (x)) & (T)", "Given"}, {"", "Given"}};
+  EXPECT_EQ(renamedSteps, renameSteps(steps, inverse));
+}
+
+TEST(SolverTest, ProveRenamed) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  // the same problem with other variable names gets the same proof
+  parse("(p -> q) & (p -> r)", lhs);
+  parse("!(p & (!q | !r))", rhs);
+  preprocess(lhs, rhs);
+  ProofResult original = proveEquivalence(lhs, rhs, deadline, cancelled);
+
+  parse("(x -> y) & (x -> w)", lhs);
+  parse("!(x & (!y | !w))", rhs);
+  preprocess(lhs, rhs);
+  ProofResult renamed = proveEquivalence(lhs, rhs, deadline, cancelled);
+  ASSERT_EQ(ProofStatus::Proved, renamed.status);
+  EXPECT_EQ(lhs->toStringTree(), renamed.steps.front()[0]);
+  EXPECT_EQ(rhs->toStringTree(), renamed.steps.back()[0]);
+
+  std::unordered_map<std::string, std::string> names = {{"x", "p"}, {"y", "q"}, {"w", "r"}};
+  EXPECT_EQ(original.steps, renameSteps(renamed.steps, names));
+}
+
+TEST(SolverTest, ProofTemplates) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  proofTemplates.clear();
+  USE_TEMPLATES = true;
+  parse("p -> q", lhs);
+  parse("!q -> !p", rhs);
+  preprocess(lhs, rhs);
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  ProofResult result = proveEquivalence(lhs, rhs, deadline, cancelled);
+  ASSERT_EQ(ProofStatus::Proved, result.status);
+  EXPECT_EQ(1, proofTemplates.size());
+
+  // the same proof with subexpressions for the variables is not searched
+  parse("(x & y) -> z", lhs);
+  parse("!z -> !(x & y)", rhs);
+  preprocess(lhs, rhs);
+  ProofResult instance = proveEquivalence(lhs, rhs, deadline, cancelled);
+  ASSERT_EQ(ProofStatus::Proved, instance.status);
+  EXPECT_EQ(0, instance.stats.expanded);
+  EXPECT_EQ(result.steps.size(), instance.steps.size());
+  EXPECT_TRUE(isValidProof(instance.steps, "(x & y) -> z", "!z -> !(x & y)"));
+  USE_TEMPLATES = false;
+  proofTemplates.clear();
+}
+
+TEST(SolverTest, Macros) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  EquivLaws::clearMacros();
+
+  // a pair of steps seen in two proofs becomes a macro. The proofs are
+  // written out, the search may take other steps depending on the build.
+  std::vector<std::vector<std::vector<std::string>>> proofs = {
+      {{"(p) -> (q)", "Given"},
+       {"(!(p)) | (q)", "Implication Equivalence"},
+       {"(q) | (!(p))", "Commutative Law"}},
+      {{"((p) & (q)) -> (r)", "Given"},
+       {"(!((p) & (q))) | (r)", "Implication Equivalence"},
+       {"(r) | (!((p) & (q)))", "Commutative Law"}}};
+  ASSERT_EQ(1, mineMacros(proofs, 4));
+  ASSERT_EQ(1, EquivLaws::macros.size());
+  EXPECT_EQ(0, mineMacros(proofs, 4, 3));
+
+  // the search uses the macro as one step, and printing expands it again
+  parse("r -> s", lhs);
+  parse("s | !r", rhs);
+  preprocess(lhs, rhs);
+  std::vector<std::vector<std::string>> steps = proveEquivalence(lhs, rhs);
+  ASSERT_EQ(2, steps.size());
+  EXPECT_EQ(EquivLaws::macros.begin()->second, steps[1][1]);
+  std::vector<std::vector<std::string>> expanded = expandMacros(steps);
+  EXPECT_EQ(3, expanded.size());
+  EXPECT_TRUE(isValidProof(expanded, "r -> s", "s | !r"));
+  EquivLaws::clearMacros();
+}
+
+TEST(SolverTest, Stats) {
+  std::shared_ptr<Expression> lhs;
+  std::shared_ptr<Expression> rhs;
+  parse("(p -> q) & (p -> r)", lhs);
+  parse("!(p & (!q | !r))", rhs);
+  preprocess(lhs, rhs);
+  std::atomic<bool> cancelled(false);
+  auto deadline = std::chrono::steady_clock::time_point::max();
+
+  // every state queued is at some depth and visited once
+  SearchStats stats = breadthFirstSearch(lhs, rhs, deadline, cancelled).stats;
+  int queued = 0;
+  for (int size : stats.frontier)
+    queued += size;
+  EXPECT_EQ(1, stats.frontier[0]);
+  EXPECT_EQ(stats.peakVisited, queued);
+  EXPECT_EQ(stats.generated + 1, queued);
+  EXPECT_GT(stats.lawAttempts["Implication Equivalence"], 0);
+  EXPECT_GT(stats.duplicates, 0);
+  EXPECT_EQ(1, stats.phaseSeconds.count("Breadth-First Search"));
+
+  int maxNodes = MAX_NODES;
+  MAX_NODES = 8;
+  EXPECT_GT(breadthFirstSearch(lhs, rhs, deadline, cancelled).stats.lengthRejected, 0);
+  MAX_NODES = maxNodes;
+
+  SearchStats total = stats;
+  addStats(total, stats);
+  EXPECT_EQ(2 * stats.expanded, total.expanded);
+  EXPECT_EQ(2 * stats.frontier[1], total.frontier[1]);
+  EXPECT_EQ(stats.peakVisited, total.peakVisited);
+  EXPECT_EQ(2 * stats.lawAttempts["Implication Equivalence"], total.lawAttempts["Implication Equivalence"]);
+
+  SearchStats small;
+  small.expanded = 2;
+  small.frontier = {1, 3};
+  small.lawAttempts["De Morgan's Law"] = 4;
+  small.phaseSeconds["Shortening"] = 0.5;
+  EXPECT_EQ("{\"expanded\":2,\"generated\":0,\"duplicates\":0,\"lengthRejected\":0,\"lawAttempts\":{\"De Morgan's Law\":4},"
+            "\"lawSuccesses\":{},\"frontier\":[1,3],\"peakMemory\":0,\"peakVisited\":0,\"seconds\":0,\"phaseSeconds\":{\"Shortening\":0.5}}",
+            statsToJson(small));
+}
@@ -0,0 +1,95 @@
+#include "../include/batch.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include "../include/tracer.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+
+
+static std::string tracePath()
+{
+  return (std::filesystem::temp_directory_path() / "logixprTracerTest.json").string();
+}
+
+static int count(const std::string &str, const std::string &part)
+{
+  int found = 0;
+  for (size_t i = str.find(part); i != std::string::npos; i = str.find(part, i + 1))
+    found++;
+  return found;
+}
+
+TEST(TracerTest, Disabled) {
+  EXPECT_FALSE(Tracer::isEnabled());
+  {
+    TraceSpan span("Ignored");
+    span.setArg("value", 1);
+  }
+  EXPECT_FALSE(Tracer::stop());
+
+  // spans begun before recording starts are left out too
+  std::unique_ptr<TraceSpan> early(new TraceSpan("Early"));
+  Tracer::start(tracePath());
+  early.reset();
+  EXPECT_EQ(0, count(Tracer::toJson(), "\"name\""));
+  EXPECT_TRUE(Tracer::stop());
+}
+
+TEST(TracerTest, Spans) {
+  Tracer::start(tracePath());
+  EXPECT_TRUE(Tracer::isEnabled());
+  {
+    TraceSpan outer("Outer");
+    TraceSpan inner("Inner \"quoted\"");
+    inner.setArg("frontier", 3);
+  }
+  auto now = std::chrono::steady_clock::now();
+  Tracer::record("Recorded", now, now + std::chrono::milliseconds(2));
+
+  std::string json = Tracer::toJson();
+  EXPECT_EQ(0, json.find("{\"traceEvents\":["));
+  EXPECT_EQ(3, count(json, "\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"Inner \\\"quoted\\\"\""));
+  EXPECT_NE(std::string::npos, json.find("\"args\":{\"frontier\":3}"));
+  EXPECT_NE(std::string::npos, json.find("\"dur\":2000"));
+
+  ASSERT_TRUE(Tracer::stop());
+  EXPECT_FALSE(Tracer::isEnabled());
+  std::ifstream file(tracePath());
+  std::string written((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(json + "\n", written);
+  std::filesystem::remove(tracePath());
+}
+
+TEST(TracerTest, Solver) {
+  std::shared_ptr<Expression> lhs, rhs;
+  parse("p -> q", lhs);
+  parse("!q -> !p", rhs);
+
+  Tracer::start(tracePath());
+  preprocess(lhs, rhs);
+  proveEquivalence(lhs, rhs);
+  std::string json = Tracer::toJson();
+  Tracer::stop();
+  std::filesystem::remove(tracePath());
+
+  EXPECT_EQ(1, count(json, "\"name\":\"Preprocess\""));
+  EXPECT_LE(1, count(json, "\"name\":\"Prove\""));
+  EXPECT_LE(1, count(json, "\"name\":\"BFS Level 0\""));
+}
+
+TEST(TracerTest, Batch) {
+  std::istringstream input("p -> q ; !p | q\np & q ; q & p\n");
+  std::ostringstream output;
+
+  Tracer::start(tracePath());
+  proveBatch(input, output, 2, 10);
+  std::string json = Tracer::toJson();
+  Tracer::stop();
+  std::filesystem::remove(tracePath());
+
+  EXPECT_EQ(2, count(json, "\"name\":\"Check Pair\""));
+  EXPECT_EQ(1, count(json, "\"name\":\"Write Results\""));
+}
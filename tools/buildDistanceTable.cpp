@@ -0,0 +1,31 @@
+/**
+ * @file buildDistanceTable.cpp
+ * @brief Build the distance table used by LogiXpr for small expressions
+ */
+
+#include "../include/distanceTable.h"
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <path> [max nodes = 7] [variables = 2]" << std::endl;
+    return 1;
+  }
+
+  int maxNodes = argc > 2 ? std::stoi(argv[2]) : 7;
+  int variables = argc > 3 ? std::stoi(argv[3]) : 2;
+  std::cout << "Building the distance table of expressions up to " << maxNodes << " nodes over " << variables << " variables..." << std::endl;
+  if (!DistanceTable::build(argv[1], maxNodes, variables))
+  {
+    std::cerr << "Couldn't build the distance table" << std::endl;
+    return 1;
+  }
+
+  DistanceTable table;
+  table.open(argv[1]);
+  std::cout << "Wrote " << table.size() << " expressions to " << argv[1] << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file generatePairs.cpp
+ * @brief Generate random pairs of equivalent expressions with known proof
+ * lengths
+ */
+
+#include "../include/generator.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+  // the flags may come anywhere
+  bool shortest = false;
+  bool corpus = false;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++)
+  {
+    if (std::strcmp(argv[i], "--shortest") == 0)
+      shortest = true;
+    else if (std::strcmp(argv[i], "--corpus") == 0)
+      corpus = true;
+    else
+      args.push_back(argv[i]);
+  }
+
+  if (args.size() < 4 || args.size() > 5)
+  {
+    std::cerr << "Usage: " << argv[0] << " <pairs> <variables> <nodes> <rewrites> [seed = 1] [--shortest] [--corpus]" << std::endl;
+    std::cerr << "  --shortest  also search for the length of a shortest proof" << std::endl;
+    std::cerr << "  --corpus    write `lhs ; rhs` lines, as read by runBenchmarks, instead of JSON Lines" << std::endl;
+    return 1;
+  }
+
+  int pairs = std::stoi(args[0]);
+  int variables = std::stoi(args[1]);
+  int nodes = std::stoi(args[2]);
+  int rewrites = std::stoi(args[3]);
+  std::mt19937 random(args.size() > 4 ? std::stoul(args[4]) : 1);
+  if (pairs < 0 || variables < 1 || variables > 26 || nodes < 1 || nodes > MAX_NODES || rewrites < 0)
+  {
+    std::cerr << "Expected 1 to 26 variables and 1 to " << MAX_NODES << " nodes" << std::endl;
+    return 1;
+  }
+
+  std::atomic<bool> cancelled(false);
+  for (int i = 0; i < pairs; i++)
+  {
+    std::shared_ptr<Expression> lhs = randomExpression(random, variables, nodes);
+    std::vector<std::vector<std::string>> steps = randomRewrites(lhs, rewrites, random);
+    std::shared_ptr<Expression> rhs;
+    parse(steps.back()[0], rhs);
+
+    // the rewrites are a proof, but a shorter one may exist
+    int length = steps.size() - 1;
+    int shortestLength = -1;
+    if (shortest)
+    {
+      preprocess(lhs, rhs);
+      ProofResult proof = breadthFirstSearch(lhs, rhs, std::chrono::steady_clock::now() + std::chrono::seconds(60), cancelled);
+      if (proof.status == ProofStatus::Proved)
+        shortestLength = proof.steps.size() - 1;
+    }
+
+    if (corpus)
+    {
+      std::cout << "# " << length << " rewrites" << (shortestLength >= 0 ? ", shortest " + std::to_string(shortestLength) : "") << std::endl;
+      std::cout << lhs->toStringMinimal() << " ; " << rhs->toStringMinimal() << std::endl;
+      continue;
+    }
+    std::cout << "{\"lhs\":\"" << lhs->toStringMinimal() << "\",\"rhs\":\"" << rhs->toStringMinimal() << "\",\"rewrites\":" << length;
+    if (shortest)
+      std::cout << ",\"shortest\":" << (shortestLength >= 0 ? std::to_string(shortestLength) : "null");
+    std::cout << ",\"laws\":[";
+    for (size_t step = 1; step < steps.size(); step++)
+      std::cout << (step == 1 ? "" : ",") << "\"" << steps[step][1] << "\"";
+    std::cout << "]}" << std::endl;
+  }
+  return 0;
+}
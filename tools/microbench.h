@@ -0,0 +1,160 @@
+/**
+ * @file microbench.h
+ * @brief Header file for the microbenchmark harness of the tools
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Harness that times small pieces of code and writes the results as
+ * JSON, so the results of two versions can be compared. Every benchmark runs
+ * in batches, doubling the batch size until a batch takes long enough to
+ * time, and reports the fastest batch, which is the least disturbed by the
+ * rest of the machine.
+ */
+class Microbench {
+public:
+  /**
+   * @brief Result of a benchmark
+   */
+  struct Result {
+    /**
+     * @brief Name of the benchmark
+     */
+    std::string name;
+
+    /**
+     * @brief Group of the benchmark, such as the part of the corpus it ran on
+     */
+    std::string group;
+
+    /**
+     * @brief Number of times the code ran in total
+     */
+    long long iterations;
+
+    /**
+     * @brief Nanoseconds per run in the fastest batch
+     */
+    double minNs;
+
+    /**
+     * @brief Nanoseconds per run over every batch
+     */
+    double meanNs;
+  };
+
+  /**
+   * @brief Create a harness
+   *
+   * @param minSeconds time every benchmark runs for at least
+   * @param batchSeconds time a batch has to take to be timed
+   */
+  Microbench(double minSeconds = 0.5, double batchSeconds = 0.01) : minSeconds(minSeconds), batchSeconds(batchSeconds) {}
+
+  /**
+   * @brief Time a piece of code and keep the result
+   *
+   * @param name name of the benchmark
+   * @param group group of the benchmark
+   * @param run the code, run many times
+   *
+   * @return the result
+   */
+  const Result &run(const std::string &name, const std::string &group, const std::function<void()> &run)
+  {
+    Result result = {name, group, 0, 0, 0};
+    long long batch = 1;
+    double total = 0;
+    double fastest = -1;
+    while (total < minSeconds)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (long long i = 0; i < batch; i++)
+        run();
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      total += seconds;
+      result.iterations += batch;
+
+      // batches too short to time are only used to find the batch size
+      if (seconds < batchSeconds && total < minSeconds)
+      {
+        batch *= 2;
+        continue;
+      }
+      double perRun = seconds / batch * 1e9;
+      fastest = fastest < 0 ? perRun : std::min(fastest, perRun);
+    }
+    result.minNs = fastest;
+    result.meanNs = total / result.iterations * 1e9;
+    results.push_back(result);
+
+    std::printf("%-40s %-24s %12.0f ns %12lld runs\n", name.c_str(), group.c_str(), result.minNs, result.iterations);
+    std::fflush(stdout);
+    return results.back();
+  }
+
+  /**
+   * @brief Render the results as JSON, one benchmark per line so two results
+   * can be compared with diff
+   *
+   * @return the JSON object of the results
+   */
+  std::string toJson() const
+  {
+    std::ostringstream json;
+    json << "{\"benchmarks\":[";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+      const Result &result = results[i];
+      json << (i == 0 ? "\n" : ",\n") << "{\"name\":" << jsonString(result.name) << ",\"group\":" << jsonString(result.group)
+           << ",\"iterations\":" << result.iterations << ",\"minNs\":" << result.minNs << ",\"meanNs\":" << result.meanNs << "}";
+    }
+    json << "\n]}";
+    return json.str();
+  }
+
+private:
+  /**
+   * @brief Quote a string for JSON
+   *
+   * @param str the string
+   *
+   * @return the string in quotes, with quotes and backslashes escaped
+   */
+  static std::string jsonString(const std::string &str)
+  {
+    std::string quoted = "\"";
+    for (char c : str)
+    {
+      if (c == '"' || c == '\\')
+        quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+
+  /**
+   * @brief Time every benchmark runs for at least
+   */
+  double minSeconds;
+
+  /**
+   * @brief Time a batch has to take to be timed
+   */
+  double batchSeconds;
+
+  /**
+   * @brief Results so far
+   */
+  std::vector<Result> results;
+};
@@ -0,0 +1,197 @@
+/**
+ * @file runBenchmarks.cpp
+ * @brief Time LogiXpr on a corpus of problems and write the results as JSON
+ */
+
+#include "../include/evaluator.h"
+#include "../include/lawIndex.h"
+#include "../include/parser.h"
+#include "../include/solver.h"
+#include "microbench.h"
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+/**
+ * @brief Problem of the corpus
+ */
+struct Problem {
+  /**
+   * @brief Left hand side as written in the corpus
+   */
+  std::string lhsString;
+
+  /**
+   * @brief Right hand side as written in the corpus
+   */
+  std::string rhsString;
+
+  /**
+   * @brief Parsed left hand side
+   */
+  std::shared_ptr<Expression> lhs = nullptr;
+
+  /**
+   * @brief Parsed right hand side
+   */
+  std::shared_ptr<Expression> rhs = nullptr;
+};
+
+/**
+ * @brief Read a corpus. Groups start with a `[name]` line and every other
+ * line holds a problem as `lhs ; rhs`. Lines starting with `#` are comments.
+ *
+ * @param path path to the corpus
+ * @param groups map to add the problems of every group to, in the order they
+ * first appear
+ * @param order names of the groups in the order they first appear
+ *
+ * @return bool of whether the corpus could be read, false if a problem is not
+ * a pair of equivalent expressions
+ */
+static bool readCorpus(const std::string &path, std::map<std::string, std::vector<Problem>> &groups, std::vector<std::string> &order)
+{
+  std::ifstream file(path);
+  if (!file.good())
+    return false;
+
+  std::string line;
+  std::string group = "default";
+  for (int number = 1; std::getline(file, line); number++)
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (line[0] == '[' && line.back() == ']')
+    {
+      group = line.substr(1, line.size() - 2);
+      continue;
+    }
+
+    size_t separator = line.find(';');
+    Problem problem = {line.substr(0, separator), separator == std::string::npos ? "" : line.substr(separator + 1)};
+    if (separator == std::string::npos || !parse(problem.lhsString, problem.lhs) || !parse(problem.rhsString, problem.rhs) || !isEquivalent(problem.lhs, problem.rhs))
+    {
+      std::cerr << path << ":" << number << ": not a pair of equivalent expressions" << std::endl;
+      return false;
+    }
+    if (groups.find(group) == groups.end())
+      order.push_back(group);
+    groups[group].push_back(problem);
+  }
+  return true;
+}
+
+/**
+ * @brief Add every subexpression of an expression
+ *
+ * @param expr the expression
+ * @param subexpressions vector to add copies of the subexpressions to
+ */
+static void collectSubexpressions(std::shared_ptr<Expression> expr, std::vector<std::shared_ptr<Expression>> &subexpressions)
+{
+  subexpressions.push_back(expr->clone());
+  if (expr->hasLeft())
+    collectSubexpressions(expr->getLeft(), subexpressions);
+  if (expr->hasRight())
+    collectSubexpressions(expr->getRight(), subexpressions);
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2 || argc > 4)
+  {
+    std::cerr << "Usage: " << argv[0] << " <corpus> [output = benchmarks.json] [min seconds = 0.5]" << std::endl;
+    return 1;
+  }
+
+  std::string outputPath = argc > 2 ? argv[2] : "benchmarks.json";
+  double minSeconds = argc > 3 ? std::stod(argv[3]) : 0.5;
+  std::map<std::string, std::vector<Problem>> groups;
+  std::vector<std::string> order;
+  if (!readCorpus(argv[1], groups, order))
+  {
+    std::cerr << "Couldn't read the corpus " << argv[1] << std::endl;
+    return 1;
+  }
+
+  Microbench bench(minSeconds);
+
+  // the front end, once per group
+  for (const std::string &group : order)
+  {
+    const std::vector<Problem> &problems = groups[group];
+    bench.run("parse", group, [&]()
+              {
+                std::shared_ptr<Expression> expr;
+                for (const Problem &problem : problems)
+                {
+                  parse(problem.lhsString, expr);
+                  parse(problem.rhsString, expr);
+                } });
+    bench.run("isEquivalent", group, [&]()
+              {
+                for (const Problem &problem : problems)
+                  isEquivalent(problem.lhs, problem.rhs); });
+  }
+
+  // every law on every subexpression of the corpus it applies to, copying
+  // the subexpression first as the search does
+  std::vector<std::shared_ptr<Expression>> subexpressions;
+  for (const std::string &group : order)
+    for (const Problem &problem : groups[group])
+    {
+      collectSubexpressions(problem.lhs, subexpressions);
+      collectSubexpressions(problem.rhs, subexpressions);
+    }
+  // the functions of a law are timed together, since they share its name
+  std::unordered_map<EquivLaws::EquivLaw, std::string> laws = EquivLaws::laws;
+  laws.insert(EquivLaws::implications.begin(), EquivLaws::implications.end());
+  laws.insert(EquivLaws::bidirectionalImplications.begin(), EquivLaws::bidirectionalImplications.end());
+  LawIndex index;
+  index.insert(laws);
+  std::map<std::string, std::vector<std::pair<EquivLaws::EquivLaw, std::shared_ptr<Expression>>>> lawCases;
+  for (std::shared_ptr<Expression> subexpression : subexpressions)
+    for (EquivLaws::EquivLaw law : index.match(subexpression))
+      lawCases[laws[law]].push_back({law, subexpression});
+  for (auto &lawCase : lawCases)
+  {
+    const std::vector<std::pair<EquivLaws::EquivLaw, std::shared_ptr<Expression>>> &cases = lawCase.second;
+    bench.run(lawCase.first, "laws", [&]()
+              {
+                for (auto &applied : cases)
+                {
+                  std::shared_ptr<Expression> copy = applied.second->clone();
+                  applied.first(copy);
+                } });
+  }
+
+  // whole proofs, each bounded so a slow problem cannot hold up the rest
+  std::atomic<bool> cancelled(false);
+  for (const std::string &group : order)
+  {
+    const std::vector<Problem> &problems = groups[group];
+    int unproved = 0;
+    bench.run("proveEquivalence", group, [&]()
+              {
+                unproved = 0;
+                for (const Problem &problem : problems)
+                {
+                  preprocess(problem.lhs, problem.rhs);
+                  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                  if (proveEquivalence(problem.lhs, problem.rhs, deadline, cancelled).status != ProofStatus::Proved)
+                    unproved++;
+                } });
+    if (unproved > 0)
+      std::cerr << unproved << " problems of " << group << " were not proved" << std::endl;
+  }
+
+  std::ofstream output(outputPath);
+  output << bench.toJson() << std::endl;
+  if (!output.good())
+  {
+    std::cerr << "Couldn't write the results to " << outputPath << std::endl;
+    return 1;
+  }
+  std::cout << "Wrote the results to " << outputPath << std::endl;
+  return 0;
+}